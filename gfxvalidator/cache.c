@@ -0,0 +1,130 @@
+
+#include "cache.h"
+
+#include <string.h>
+
+#define FNV_OFFSET_BASIS    2166136261u
+#define FNV_PRIME           16777619u
+
+// display lists tend to share alignment so the address is mixed before
+// picking a set
+#define GFX_CACHE_SET_INDEX(cache, listAddress) ((((listAddress) >> 3) * 2654435761u >> 16) & ((cache)->setCount - 1))
+#define GFX_CACHE_SET(cache, listAddress)       (&(cache)->entries[GFX_CACHE_SET_INDEX(cache, listAddress) * GFX_CACHE_WAYS])
+
+void gfxCacheInit(struct GFXValidationCache* cache, struct GFXCacheEntry* entries, int setCount) {
+    int i;
+
+    cache->entries = entries;
+    cache->setCount = setCount;
+    cache->generation = 0;
+    cache->hits = 0;
+    cache->misses = 0;
+
+    for (i = 0; i < setCount * GFX_CACHE_WAYS; ++i) {
+        entries[i].listAddress = 0;
+    }
+}
+
+void gfxCacheInvalidate(struct GFXValidationCache* cache, u32 listAddress) {
+    struct GFXCacheEntry* set = GFX_CACHE_SET(cache, listAddress);
+    int i;
+
+    for (i = 0; i < GFX_CACHE_WAYS; ++i) {
+        if (set[i].listAddress == listAddress) {
+            set[i].listAddress = 0;
+        }
+    }
+}
+
+void gfxCacheInvalidateAll(struct GFXValidationCache* cache) {
+    // entries from older generations never match again
+    ++cache->generation;
+}
+
+u32 gfxCacheKey(struct GFXPipelineState* pipeline, int stackDepth, int microcode, int level) {
+    unsigned char* curr = (unsigned char*)pipeline;
+    unsigned char* end = curr + sizeof(struct GFXPipelineState);
+    u32 result = FNV_OFFSET_BASIS ^ stackDepth ^ (microcode << 8) ^ (level << 16);
+
+    while (curr < end) {
+        result = (result ^ *curr) * FNV_PRIME;
+        ++curr;
+    }
+
+    return result;
+}
+
+struct GFXCacheEntry* gfxCacheFind(struct GFXValidationCache* cache, u32 listAddress, u32 key, struct GFXPipelineState* entryState, int stackDepth, int microcode, int level) {
+    struct GFXCacheEntry* set = GFX_CACHE_SET(cache, listAddress);
+    int i;
+
+    for (i = 0; i < GFX_CACHE_WAYS; ++i) {
+        struct GFXCacheEntry* entry = &set[i];
+
+        if (entry->listAddress == listAddress && 
+            entry->key == key && 
+            entry->generation == cache->generation &&
+            entry->commandCount >= 0 &&
+            entry->stackDepth == stackDepth &&
+            entry->microcode == microcode &&
+            entry->level == level &&
+            memcmp(&entry->entryState, entryState, sizeof(struct GFXPipelineState)) == 0) {
+            if (i != 0) {
+                // keep the most recently used entry first
+                struct GFXCacheEntry tmp = set[0];
+                set[0] = *entry;
+                *entry = tmp;
+            }
+
+            ++cache->hits;
+            return &set[0];
+        }
+    }
+
+    ++cache->misses;
+    return 0;
+}
+
+void gfxCacheBegin(struct GFXValidationCache* cache, u32 listAddress, u32 key, struct GFXPipelineState* entryState, int stackDepth, int microcode, int level) {
+    struct GFXCacheEntry* set = GFX_CACHE_SET(cache, listAddress);
+    int i;
+
+    // an entry with the same key is replaced so gfxCacheStore only ever
+    // finds one, otherwise the least recently used entry is evicted
+    for (i = 0; i < GFX_CACHE_WAYS - 1; ++i) {
+        if (set[i].listAddress == listAddress && set[i].key == key) {
+            break;
+        }
+    }
+
+    for (; i > 0; --i) {
+        set[i] = set[i - 1];
+    }
+
+    set[0].listAddress = listAddress;
+    set[0].key = key;
+    set[0].generation = cache->generation;
+    set[0].commandCount = -1;
+    set[0].stackDepth = stackDepth;
+    set[0].microcode = microcode;
+    set[0].level = level;
+    // copied bytewise so padding compares equal in gfxCacheFind
+    memcpy(&set[0].entryState, entryState, sizeof(struct GFXPipelineState));
+}
+
+void gfxCacheStore(struct GFXValidationCache* cache, u32 listAddress, u32 key, int commandCount, struct GFXPipelineState* exitState) {
+    struct GFXCacheEntry* set = GFX_CACHE_SET(cache, listAddress);
+    int i;
+
+    for (i = 0; i < GFX_CACHE_WAYS; ++i) {
+        struct GFXCacheEntry* entry = &set[i];
+
+        // nothing is stored if the entry was evicted while the display list
+        // was being walked
+        if (entry->listAddress == listAddress && entry->key == key && entry->generation == cache->generation && entry->commandCount < 0) {
+            entry->commandCount = commandCount;
+            entry->exitState = *exitState;
+            return;
+        }
+    }
+}
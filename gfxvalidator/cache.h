@@ -0,0 +1,50 @@
+#ifndef _GFX_VALIDATOR_CACHE_H
+#define _GFX_VALIDATOR_CACHE_H
+
+#include "validator.h"
+
+// number of entries sharing a set, a display list can be cached with this
+// many different starting states at once
+#define GFX_CACHE_WAYS  2
+
+struct GFXCacheEntry {
+    // 0 when the entry is empty
+    u32 listAddress;
+    u32 key;
+    u32 generation;
+    // -1 until the display list returns
+    int commandCount;
+    // the key is only a hash, a hit compares all of these
+    char stackDepth;
+    u8 microcode;
+    u8 level;
+    struct GFXPipelineState entryState;
+    struct GFXPipelineState exitState;
+};
+
+struct GFXValidationCache {
+    struct GFXCacheEntry* entries;
+    // number of sets, entries has setCount * GFX_CACHE_WAYS elements
+    int setCount;
+    u32 generation;
+    int hits;
+    int misses;
+};
+
+// setCount must be a power of 2 no larger than 65536
+void gfxCacheInit(struct GFXValidationCache* cache, struct GFXCacheEntry* entries, int setCount);
+// call when the display list at address or any data it references changes
+void gfxCacheInvalidate(struct GFXValidationCache* cache, u32 listAddress);
+// call when the contents of any cached display list may have changed
+void gfxCacheInvalidateAll(struct GFXValidationCache* cache);
+
+// microcode is the enum GFXMicrocodeId and level the enum
+// GFXValidationLevel the display list is validated with
+u32 gfxCacheKey(struct GFXPipelineState* pipeline, int stackDepth, int microcode, int level);
+struct GFXCacheEntry* gfxCacheFind(struct GFXValidationCache* cache, u32 listAddress, u32 key, struct GFXPipelineState* entryState, int stackDepth, int microcode, int level);
+// takes an entry for a display list about to be walked, it can't be found
+// until gfxCacheStore records where the display list ends up
+void gfxCacheBegin(struct GFXValidationCache* cache, u32 listAddress, u32 key, struct GFXPipelineState* entryState, int stackDepth, int microcode, int level);
+void gfxCacheStore(struct GFXValidationCache* cache, u32 listAddress, u32 key, int commandCount, struct GFXPipelineState* exitState);
+
+#endif
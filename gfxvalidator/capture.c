@@ -0,0 +1,177 @@
+
+#include "capture.h"
+#include "encoding.h"
+#include "gfx_macros.h"
+
+#include <string.h>
+
+#define FNV_OFFSET_BASIS    2166136261u
+#define FNV_PRIME           16777619u
+
+void gfxCaptureWriterInit(struct GFXCaptureWriter* writer, gfxPrinter write, struct GFXHazardMap* reads, struct GFXCaptureBlob* blobs, u32 capacity) {
+    writer->write = write;
+    writer->reads = reads;
+    writer->blobs = blobs;
+    writer->capacity = capacity;
+    writer->dataRecords = 0;
+    writer->chunks = 0;
+    writer->repeatedChunks = 0;
+    writer->bytes = 0;
+}
+
+u32 gfxCaptureHash(unsigned char* data, u32 length) {
+    u32 result = FNV_OFFSET_BASIS;
+    u32 i;
+
+    for (i = 0; i < length; ++i) {
+        result = (result ^ data[i]) * FNV_PRIME;
+    }
+
+    return result;
+}
+
+void gfxCaptureWrite(struct GFXCaptureWriter* writer, void* data, u32 length) {
+    writer->write((char*)data, length);
+    writer->bytes += length;
+}
+
+void gfxCaptureRecord(struct GFXCaptureWriter* writer, int type, u32 address, u32 length) {
+    unsigned char record[GFX_CAPTURE_RECORD_SIZE];
+
+    record[0] = (unsigned char)type;
+    record[1] = 0;
+    record[2] = 0;
+    record[3] = 0;
+    gfxEncodeWord(record + 4, address);
+    gfxEncodeWord(record + 8, length);
+    gfxCaptureWrite(writer, record, GFX_CAPTURE_RECORD_SIZE);
+}
+
+void gfxCaptureChunk(struct GFXCaptureWriter* writer, struct GFXMemory* memory, u32 address, u32 length) {
+    unsigned char* data = gfxMemoryResolve(memory, address, length);
+    struct GFXCaptureBlob* blob = 0;
+    u32 hash;
+    u32 probe;
+    u32 slot;
+
+    if (!data) {
+        return;
+    }
+
+    hash = gfxCaptureHash(data, length);
+    slot = hash & (writer->capacity - 1);
+    ++writer->chunks;
+
+    for (probe = 0; probe < writer->capacity; ++probe) {
+        blob = &writer->blobs[slot];
+
+        if (!blob->length) {
+            break;
+        }
+
+        if (blob->hash == hash && blob->length == length && memcmp(gfxMemoryResolve(memory, blob->address, length), data, length) == 0) {
+            unsigned char index[4];
+            gfxCaptureRecord(writer, GFX_CAPTURE_REPEAT, address, length);
+            gfxEncodeWord(index, blob->index);
+            gfxCaptureWrite(writer, index, 4);
+            ++writer->repeatedChunks;
+            return;
+        }
+
+        slot = (slot + 1) & (writer->capacity - 1);
+        blob = 0;
+    }
+
+    if (blob) {
+        blob->hash = hash;
+        blob->address = address;
+        blob->length = length;
+        blob->index = writer->dataRecords;
+    }
+
+    gfxCaptureRecord(writer, GFX_CAPTURE_DATA, address, length);
+    gfxCaptureWrite(writer, data, length);
+    ++writer->dataRecords;
+}
+
+enum GFXValidatorError gfxCaptureDisplayList(u32 address, int maxGfxCount, struct GFXValidatorOptions* options, struct GFXCaptureWriter* writer, struct GFXValidationResult* result) {
+    struct GFXValidatorOptions captureOptions = *options;
+    struct GFXMemory* memory = options->memory;
+    unsigned char header[GFX_CAPTURE_HEADER_SIZE];
+    enum GFXValidatorError error;
+    u32 start;
+    u32 end;
+    u32 i;
+
+#ifndef GFX_HOST
+    struct GFXMemory consoleMemory;
+
+    if (!memory) {
+        gfxConsoleMemoryInit(&consoleMemory);
+        memory = &consoleMemory;
+    }
+#endif
+
+    for (i = 0; i < writer->capacity; ++i) {
+        writer->blobs[i].length = 0;
+    }
+
+    writer->dataRecords = 0;
+
+    gfxHazardMapClear(writer->reads);
+    captureOptions.memory = memory;
+    captureOptions.hazards = writer->reads;
+
+    error = gfxValidateDisplayList(address, maxGfxCount, &captureOptions, result);
+
+    header[0] = 'G';
+    header[1] = 'C';
+    header[2] = GFX_CAPTURE_VERSION;
+    header[3] = result->microcode;
+    gfxEncodeWord(header + 4, memory->size);
+    gfxEncodeWord(header + 8, address);
+
+    for (i = 0; i < GFX_MAX_SEGMENTS; ++i) {
+        gfxEncodeWord(header + 12 + i * 4, options->segments ? options->segments[i] : GFX_SEGMENT_UNSET);
+    }
+
+    gfxCaptureWrite(writer, header, GFX_CAPTURE_HEADER_SIZE);
+
+    for (start = 0; gfxHazardNextRange(writer->reads, start, &start, &end); start = end) {
+        while (start < end) {
+            u32 chunkEnd = (start & ~(GFX_CAPTURE_CHUNK_SIZE - 1)) + GFX_CAPTURE_CHUNK_SIZE;
+
+            if (chunkEnd > end) {
+                chunkEnd = end;
+            }
+
+            gfxCaptureChunk(writer, memory, start, chunkEnd - start);
+            start = chunkEnd;
+        }
+    }
+
+    gfxCaptureRecord(writer, GFX_CAPTURE_END, 0, 0);
+
+    return error;
+}
+
+enum GFXValidatorError gfxCaptureTaskAt(u32 taskAddress, int maxGfxCount, struct GFXValidatorOptions* options, struct GFXCaptureWriter* writer, struct GFXValidationResult* result) {
+    u32* task = gfxMemoryResolve(options->memory, taskAddress, GFX_TASK_SIZE);
+
+    if (!task || GFX_WORD(task[GFX_TASK_TYPE_OFFSET / 4]) != M_GFXTASK) {
+        // reports the same result without writing anything
+        return gfxValidateTaskAt(taskAddress, maxGfxCount, options, result);
+    }
+
+    return gfxCaptureDisplayList(K0_TO_PHYS(GFX_WORD(task[GFX_TASK_DATA_PTR_OFFSET / 4])), maxGfxCount, options, writer, result);
+}
+
+#ifndef GFX_HOST
+enum GFXValidatorError gfxCaptureTask(OSTask* task, int maxGfxCount, struct GFXValidatorOptions* options, struct GFXCaptureWriter* writer, struct GFXValidationResult* result) {
+    if (task->t.type != M_GFXTASK) {
+        return gfxValidate(task, maxGfxCount, result);
+    }
+
+    return gfxCaptureDisplayList(K0_TO_PHYS(task->t.data_ptr), maxGfxCount, options, writer, result);
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,77 @@
+#ifndef _GFX_VALIDATOR_CAPTURE_H
+#define _GFX_VALIDATOR_CAPTURE_H
+
+#include "validator.h"
+#include "hazards.h"
+
+// everything a display list reads, written a record at a time so it can be
+// streamed off the console. all words are big endian
+//
+//   0   'G' 'C' GFX_CAPTURE_VERSION microcode
+//   4   size of RDRAM
+//   8   physical address of the root display list
+//   12  GFX_MAX_SEGMENTS segment addresses the display list starts with,
+//       GFX_SEGMENT_UNSET for segments it sets itself
+//
+// then records in increasing address order until GFX_CAPTURE_END
+//
+//   0   type 0 0 0
+//   4   physical address
+//   8   length, a multiple of 16
+//   12  GFX_CAPTURE_DATA: the bytes as they were in RDRAM
+//       GFX_CAPTURE_REPEAT: index of the earlier data record with the same
+//       bytes
+#define GFX_CAPTURE_VERSION         2
+#define GFX_CAPTURE_HEADER_SIZE     (12 + GFX_MAX_SEGMENTS * 4)
+#define GFX_CAPTURE_RECORD_SIZE     12
+
+#define GFX_CAPTURE_DATA            1
+#define GFX_CAPTURE_REPEAT          2
+#define GFX_CAPTURE_END             3
+
+// memory read by the display list is split into chunks that never cross a
+// multiple of this so buffers with the same contents are stored once
+#define GFX_CAPTURE_CHUNK_SIZE      1024
+
+// a data record that was already written
+struct GFXCaptureBlob {
+    u32 hash;
+    u32 address;
+    // 0 for an empty slot
+    u32 length;
+    u32 index;
+};
+
+struct GFXCaptureWriter {
+    // receives the capture a piece at a time in order
+    gfxPrinter write;
+    // used to find the memory the display list reads, its lines must cover
+    // all of RDRAM
+    struct GFXHazardMap* reads;
+    // open addressed on the content hash, capacity must be a power of 2.
+    // once it is full new data is always written out
+    struct GFXCaptureBlob* blobs;
+    u32 capacity;
+    u32 dataRecords;
+    // totals for the captures written so far
+    u32 chunks;
+    u32 repeatedChunks;
+    u32 bytes;
+};
+
+void gfxCaptureWriterInit(struct GFXCaptureWriter* writer, gfxPrinter write, struct GFXHazardMap* reads, struct GFXCaptureBlob* blobs, u32 capacity);
+
+// validates the display list at address and writes out everything it read.
+// the capture is written even if validation fails, the error is returned.
+// the writer's blobs are forgotten first since their indices are per
+// capture. options.hazards and options.cache are ignored
+enum GFXValidatorError gfxCaptureDisplayList(u32 address, int maxGfxCount, struct GFXValidatorOptions* options, struct GFXCaptureWriter* writer, struct GFXValidationResult* result);
+// captures the OSTask at the physical address taskAddress, nothing is
+// written when it isn't a graphics task or can't be read
+enum GFXValidatorError gfxCaptureTaskAt(u32 taskAddress, int maxGfxCount, struct GFXValidatorOptions* options, struct GFXCaptureWriter* writer, struct GFXValidationResult* result);
+
+#ifndef GFX_HOST
+enum GFXValidatorError gfxCaptureTask(OSTask* task, int maxGfxCount, struct GFXValidatorOptions* options, struct GFXCaptureWriter* writer, struct GFXValidationResult* result);
+#endif
+
+#endif
\ No newline at end of file
@@ -1,254 +1,379 @@
 
 #include "command_printer.h"
-#include "validator.h"
-#include <string.h>
+#include "validator_internal.h"
+#include "format.h"
 #include "gfx_macros.h"
 
-typedef int (*GFXValidatorPrinter)(Gfx command, char* output, unsigned maxOutputLength);
+const char* const gfxImageFormatNames[] = {
+    "G_IM_FMT_RGBA",
+    "G_IM_FMT_YUV",
+    "G_IM_FMT_CI",
+    "G_IM_FMT_IA",
+    "G_IM_FMT_I",
+};
+
+const char* const gfxImageSizeNames[] = {
+    "G_IM_SIZ_4b",
+    "G_IM_SIZ_8b",
+    "G_IM_SIZ_16b",
+    "G_IM_SIZ_32b",
+};
+
+const char* gfxImageFormatName(int format) {
+    return format < (int)(sizeof(gfxImageFormatNames) / sizeof(*gfxImageFormatNames)) ? gfxImageFormatNames[format] : "*";
+}
+
+#define IMAGE_FORMAT(gfx)   gfxImageFormatName(_SHIFTR(GFX_W0(gfx), 21, 3))
+#define IMAGE_SIZE(gfx)     gfxImageSizeNames[_SHIFTR(GFX_W0(gfx), 19, 2)]
+#define IMAGE_WIDTH(gfx)    (_SHIFTR(GFX_W0(gfx), 0, 12) + 1)
+
+// 10.2 fixed point fields shared by the rectangle and tile commands
+#define RECT_X0(gfx)        _SHIFTR(GFX_W1(gfx), 12, 12)
+#define RECT_Y0(gfx)        _SHIFTR(GFX_W1(gfx), 0, 12)
+#define RECT_X1(gfx)        _SHIFTR(GFX_W0(gfx), 12, 12)
+#define RECT_Y1(gfx)        _SHIFTR(GFX_W0(gfx), 0, 12)
+#define RECT_TILE(gfx)      _SHIFTR(GFX_W1(gfx), 24, 3)
 
 int gfxUnknownCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
-    return sprintf(output, "unknown 0x%08x%08x", (unsigned)(command.force_structure_alignment >> 32), (unsigned)command.force_structure_alignment);
+    return gfxFormat(output, maxOutputLength, "unknown 0x%08x%08x", GFX_W0(&command), GFX_W1(&command));
+}
+
+int gfxRawCommandPrinter(const char* name, Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(output, maxOutputLength, "%s(0x%06x, 0x%08x)", name, _SHIFTR(GFX_W0(&command), 0, 24), GFX_W1(&command));
+}
+
+int gfxNoopCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(output, maxOutputLength, "gsSPNoOp()");
 }
 
 int gfxDLCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
-    if (command.dma.par == G_DL_NOPUSH) {
-        return sprintf(output, "gsSPBranchList(0x%08x)", command.words.w1);
+    if (DMA1_PARAM(&command) == G_DL_NOPUSH) {
+        return gfxFormat(output, maxOutputLength, "gsSPBranchList(0x%08x)", GFX_W1(&command));
     } else {
-        return sprintf(output, "gsSPDisplayList(0x%08x)", command.words.w1);
+        return gfxFormat(output, maxOutputLength, "gsSPDisplayList(0x%08x)", GFX_W1(&command));
     }
 }
 
-int gfxMtxCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) { 
-    int flags = DMA_MM_IDX(&command);
-
-#ifdef F3DEX_GBI_2
-    flags ^= G_MTX_PUSH;
-#endif
-
-    return sprintf(
-        output, 
-        "gsSPMatrix(0x%08x, %s | %s | %s)", 
-        command.words.w1,
-        (flags & G_MTX_PROJECTION) ? "G_MTX_PROJECTION" : "G_MTX_MODELVIEW",
-        (flags & G_MTX_LOAD) ? "G_MTX_LOAD" : "G_MTX_MUL",
-        (flags & G_MTX_PUSH) ? "G_MTX_PUSH" : "G_MTX_NOPUSH"
-    );
-}
-
-int gfxMoveMemCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) { 
-    int location = DMA_MM_IDX(&command);
-
-    switch (location) {
-        case G_MV_VIEWPORT:
-            return sprintf(
-                output, 
-                "gsSPViewport(0x%08x)", 
-                command.words.w1
-            );
-#ifdef	F3DEX_GBI_2
-        case G_MV_MATRIX:
-            return sprintf(
-                output, 
-                "gsSPForceMatrix(0x%08x)", 
-                command.words.w1
-            );
-        case G_MV_LIGHT:
-            return sprintf(
-                output, 
-                "gsSPLight(0x%08x, %d)", 
-                command.words.w1,
-                (DMA_MM_OFS(&command) - 24) / 24
-            );
-        case G_MVO_LOOKATX:
-            return sprintf(
-                output, 
-                "gsSPLookAtX(0x%08x)", 
-                command.words.w1
-            );
-        case G_MVO_LOOKATY:
-            return sprintf(
-                output, 
-                "gsSPLookAtY(0x%08x)", 
-                command.words.w1
-            );
-#else
-        // TODO Old gfx
-#endif
+int gfxEndDLCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(output, maxOutputLength, "gsSPEndDisplayList()");
+}
+
+int gfxRDPHalf1CommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(output, maxOutputLength, "gsImmp1(G_RDPHALF_1, 0x%08x)", GFX_W1(&command));
+}
+
+int gfxRDPHalf2CommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(output, maxOutputLength, "gsImmp1(G_RDPHALF_2, 0x%08x)", GFX_W1(&command));
+}
+
+int gfxLoadUcodeCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxRawCommandPrinter("gsSPLoadUcodeEx", command, output, maxOutputLength);
+}
+
+int gfxDmaIOCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxRawCommandPrinter("gsSPDma_io", command, output, maxOutputLength);
+}
+
+int gfxSpecialCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsSpecial(0x%02x, 0x%06x, 0x%08x)",
+        GFX_COMMAND(&command),
+        _SHIFTR(GFX_W0(&command), 0, 24),
+        GFX_W1(&command)
+    );
+}
+
+int gfxRDPNoopCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(output, maxOutputLength, "gsDPNoOp()");
+}
+
+int gfxSetColorImageCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsDPSetColorImage(%s, %s, %d, 0x%08x)",
+        IMAGE_FORMAT(&command),
+        IMAGE_SIZE(&command),
+        IMAGE_WIDTH(&command),
+        GFX_W1(&command)
+    );
+}
+
+int gfxSetDepthImageCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(output, maxOutputLength, "gsDPSetDepthImage(0x%08x)", GFX_W1(&command));
+}
+
+int gfxSetTextureImageCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsDPSetTextureImage(%s, %s, %d, 0x%08x)",
+        IMAGE_FORMAT(&command),
+        IMAGE_SIZE(&command),
+        IMAGE_WIDTH(&command),
+        GFX_W1(&command)
+    );
+}
+
+int gfxSetCombineCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxRawCommandPrinter("gsDPSetCombine", command, output, maxOutputLength);
+}
+
+int gfxSetColorCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    const char* name;
+
+    switch (GFX_COMMAND(&command)) {
+        case (u8)G_SETENVCOLOR:
+            name = "gsDPSetEnvColor";
+            break;
+        case (u8)G_SETBLENDCOLOR:
+            name = "gsDPSetBlendColor";
+            break;
         default:
-        return sprintf(
-            output, 
-            "gsDma2p(G_MOVEMEM, 0x%08x, *, 0x%x, *)", 
-            command.words.w1,
-            location
-        );
+            name = "gsDPSetFogColor";
+            break;
     }
+
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "%s(%d, %d, %d, %d)",
+        name,
+        _SHIFTR(GFX_W1(&command), 24, 8),
+        _SHIFTR(GFX_W1(&command), 16, 8),
+        _SHIFTR(GFX_W1(&command), 8, 8),
+        _SHIFTR(GFX_W1(&command), 0, 8)
+    );
 }
 
-int gfxVtxCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) { 
-    int vtxCount;
-    int v0;
-#ifdef F3DEX_GBI_2
-    vtxCount = _SHIFTR(command.words.w0, 12, 8);
-    v0 = _SHIFTR(command.words.w0, 1, 7) - vtxCount;
-#else
-    vtxCount = (DMA1_PARAM(&command) >> 4) + 1;
-    v0 = DMA1_PARAM(&command) & 0xF;
-#endif
-    return sprintf(
-        output, 
-        "gsSPVertex(0x%08x, %d, %d)", 
-        command.words.w1,
-        vtxCount,
-        v0
-    );
-}
-
-int gfxTri1CommandPrinter(Gfx command, char* output, unsigned maxOutputLength) { 
-#ifdef F3DEX_GBI_2
-    int v0 = _SHIFTR(command.words.w0, 16, 8);
-    int v1 = _SHIFTR(command.words.w0, 8, 8);
-    int v2 = _SHIFTR(command.words.w0, 0, 8);
-#else
-    int v0 = _SHIFTR(command.words.w1, 16, 8);
-    int v1 = _SHIFTR(command.words.w1, 8, 8);
-    int v2 = _SHIFTR(command.words.w1, 0, 8);
-#endif
-
-    return sprintf(
-        output, 
-        "gsSP1Triangle(%d, %d, %d, 0)", 
-        command.words.w1,
-        v0,
-        v1,
-        v2
-    );
-}
-
-int gfxTri2CommandPrinter(Gfx command, char* output, unsigned maxOutputLength) { 
-    return sprintf(
-        output, 
-        "gsSP2Triangles(%d, %d, %d, 0, %d, %d, %d, 0)", 
-        command.words.w1,
-        _SHIFTR(command.words.w0, 16, 8), 
-        _SHIFTR(command.words.w0, 8, 8), 
-        _SHIFTR(command.words.w0, 0, 8),
-        _SHIFTR(command.words.w1, 16, 8), 
-        _SHIFTR(command.words.w1, 8, 8), 
-        _SHIFTR(command.words.w1, 0, 8)
-    );
-}
-
-int gfxPopMtxCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) { 
-    int popCount;
-#ifdef F3DEX_GBI_2
-    popCount = command.words.w1 >> 6;
-#else
-    popCount = 1;
-#endif
-
-    if (popCount == 1) {
-        return sprintf(
-            output, 
-            "gsSPPopMatrix(G_MTX_MODELVIEW)"
-        );
-    }
+int gfxSetPrimColorCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsDPSetPrimColor(%d, %d, %d, %d, %d, %d)",
+        _SHIFTR(GFX_W0(&command), 8, 8),
+        _SHIFTR(GFX_W0(&command), 0, 8),
+        _SHIFTR(GFX_W1(&command), 24, 8),
+        _SHIFTR(GFX_W1(&command), 16, 8),
+        _SHIFTR(GFX_W1(&command), 8, 8),
+        _SHIFTR(GFX_W1(&command), 0, 8)
+    );
+}
+
+int gfxSetFillColorCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(output, maxOutputLength, "gsDPSetFillColor(0x%08x)", GFX_W1(&command));
+}
+
+int gfxFillRectCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsDPFillRectangle(%d, %d, %d, %d)",
+        RECT_X0(&command) >> 2,
+        RECT_Y0(&command) >> 2,
+        RECT_X1(&command) >> 2,
+        RECT_Y1(&command) >> 2
+    );
+}
+
+int gfxSetTileCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsDPSetTile(%s, %s, %d, 0x%03x, %d, %d, %d, %d, %d, %d, %d, %d)",
+        IMAGE_FORMAT(&command),
+        IMAGE_SIZE(&command),
+        _SHIFTR(GFX_W0(&command), 9, 9),
+        _SHIFTR(GFX_W0(&command), 0, 9),
+        _SHIFTR(GFX_W1(&command), 24, 3),
+        _SHIFTR(GFX_W1(&command), 20, 4),
+        _SHIFTR(GFX_W1(&command), 18, 2),
+        _SHIFTR(GFX_W1(&command), 14, 4),
+        _SHIFTR(GFX_W1(&command), 10, 4),
+        _SHIFTR(GFX_W1(&command), 8, 2),
+        _SHIFTR(GFX_W1(&command), 4, 4),
+        _SHIFTR(GFX_W1(&command), 0, 4)
+    );
+}
+
+// G_LOADTILE and G_SETTILESIZE share the layout of G_TEXRECT with the
+// corners swapped between the words
+int gfxTileRectCommandPrinter(const char* name, Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "%s(%d, %d, %d, %d, %d)",
+        name,
+        RECT_TILE(&command),
+        RECT_X1(&command),
+        RECT_Y1(&command),
+        RECT_X0(&command),
+        RECT_Y0(&command)
+    );
+}
+
+int gfxSetTileSizeCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxTileRectCommandPrinter("gsDPSetTileSize", command, output, maxOutputLength);
+}
+
+int gfxLoadTileCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxTileRectCommandPrinter("gsDPLoadTile", command, output, maxOutputLength);
+}
+
+int gfxLoadBlockCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsDPLoadBlock(%d, %d, %d, %d, %d)",
+        RECT_TILE(&command),
+        RECT_X1(&command),
+        RECT_Y1(&command),
+        RECT_X0(&command),
+        RECT_Y0(&command)
+    );
+}
+
+int gfxLoadTLUTCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsDPLoadTLUTCmd(%d, %d)",
+        RECT_TILE(&command),
+        _SHIFTR(GFX_W1(&command), 14, 10)
+    );
+}
+
+int gfxRDPSetOtherModeCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxRawCommandPrinter("gsDPSetOtherMode", command, output, maxOutputLength);
+}
+
+int gfxSetPrimDepthCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsDPSetPrimDepth(%d, %d)",
+        (s16)_SHIFTR(GFX_W1(&command), 16, 16),
+        (s16)_SHIFTR(GFX_W1(&command), 0, 16)
+    );
+}
+
+int gfxSetScissorCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    const char* mode;
 
-    return sprintf(
-        output, 
-        "gsSPPopMatrixN(G_MTX_MODELVIEW, %d)",
-        popCount
-    );
-}
-
-int gfxMoveWordCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) { 
-    int index = MOVE_WORD_IDX(&command);
-    int offset = MOVE_WORD_OFS(&command);
-    int data = MOVE_WORD_DATA(&command);
-
-    switch (index) {
-        case G_MW_SEGMENT:
-            return sprintf(
-                output, 
-                "gsSPPopMatrixN(0x%x, 0x%08x)",
-                offset >> 2,
-                command.words.w1
-            );
-        case G_MW_CLIP:
-            return sprintf(
-                output, 
-                "gsSPClipRatio(*)"
-            );
-        case G_MW_MATRIX:
-            return sprintf(
-                output, 
-                "gsSPInsertMatrix(*)"
-            );
-#ifdef F3DEX_GBI_2
-        case G_MW_FORCEMTX:
-            return sprintf(
-                output, 
-                "gsSPInsertMatrix(*)"
-            );
-#else
-        case G_MW_POINTS:
-            return sprintf(
-                output, 
-                "gsSPModifyVertex(*)"
-            );
-#endif // F3DEX_GBI_2
-        case G_MW_NUMLIGHT:
-            return sprintf(
-                output, 
-                "gsSPNumLights(%d)",
-                data / 24
-            );
-        case G_MW_LIGHTCOL:
-            return sprintf(
-                output, 
-                "gsSPLightColor(*, %x)",
-                data
-            );
-        case G_MW_FOG:
-            return sprintf(
-                output, 
-                "gsSPFog*(*)"
-            );
-        case G_MW_PERSPNORM:
-            return sprintf(
-                output, 
-                "gsSPPerspNormalize(%d)",
-                data
-            );
+    switch (_SHIFTR(GFX_W1(&command), 24, 2)) {
+        case G_SC_NON_INTERLACE:
+            mode = "G_SC_NON_INTERLACE";
+            break;
+        case G_SC_EVEN_INTERLACE:
+            mode = "G_SC_EVEN_INTERLACE";
+            break;
+        case G_SC_ODD_INTERLACE:
+            mode = "G_SC_ODD_INTERLACE";
+            break;
         default:
-            return sprintf(
-                output, 
-                "gsMoveWd(%d, %d, %d)",
-                index,
-                offset,
-                data
-            );
+            mode = "*";
+            break;
     }
+
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsDPSetScissorFrac(%s, %d, %d, %d, %d)",
+        mode,
+        RECT_X1(&command),
+        RECT_Y1(&command),
+        RECT_X0(&command),
+        RECT_Y0(&command)
+    );
 }
 
-GFXValidatorPrinter gfxCommandPrinters[GFX_MAX_COMMAND_LEN] = {
-    [G_DL] = gfxDLCommandPrinter,
-    [G_MTX] = gfxMtxCommandPrinter,
-    [G_MOVEMEM] = gfxMoveMemCommandPrinter,
-    [G_VTX] = gfxVtxCommandPrinter,
-    [G_TRI1] = gfxTri1CommandPrinter,
-    [G_TRI2] = gfxTri2CommandPrinter,
-    [G_POPMTX] = gfxPopMtxCommandPrinter,
-    [G_MOVEWORD] = gfxMoveWordCommandPrinter,
-};
+int gfxSetConvertCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsDPSetConvert(%d, %d, %d, %d, %d, %d)",
+        _SHIFTR(GFX_W0(&command), 13, 9),
+        _SHIFTR(GFX_W0(&command), 4, 9),
+        (_SHIFTR(GFX_W0(&command), 0, 4) << 5) | _SHIFTR(GFX_W1(&command), 27, 5),
+        _SHIFTR(GFX_W1(&command), 18, 9),
+        _SHIFTR(GFX_W1(&command), 9, 9),
+        _SHIFTR(GFX_W1(&command), 0, 9)
+    );
+}
 
-unsigned gfxPrintCommand(Gfx command, char* output, unsigned maxOutputLen) {
-    unsigned commandType = (unsigned)(command.force_structure_alignment >> 56) & 0xFF;
+int gfxSetKeyRCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsDPSetKeyR(%d, %d, %d)",
+        _SHIFTR(GFX_W1(&command), 8, 8),
+        _SHIFTR(GFX_W1(&command), 0, 8),
+        _SHIFTR(GFX_W1(&command), 16, 12)
+    );
+}
+
+int gfxSetKeyGBCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsDPSetKeyGB(%d, %d, %d, %d, %d, %d)",
+        _SHIFTR(GFX_W1(&command), 24, 8),
+        _SHIFTR(GFX_W1(&command), 16, 8),
+        _SHIFTR(GFX_W0(&command), 12, 12),
+        _SHIFTR(GFX_W1(&command), 8, 8),
+        _SHIFTR(GFX_W1(&command), 0, 8),
+        _SHIFTR(GFX_W0(&command), 0, 12)
+    );
+}
 
-    GFXValidatorPrinter printer = gfxCommandPrinters[commandType];
+int gfxSyncCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    const char* name;
+
+    switch (GFX_COMMAND(&command)) {
+        case (u8)G_RDPFULLSYNC:
+            name = "gsDPFullSync";
+            break;
+        case (u8)G_RDPTILESYNC:
+            name = "gsDPTileSync";
+            break;
+        case (u8)G_RDPPIPESYNC:
+            name = "gsDPPipeSync";
+            break;
+        default:
+            name = "gsDPLoadSync";
+            break;
+    }
+
+    return gfxFormat(output, maxOutputLength, "%s()", name);
+}
+
+int gfxTextureRectCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    // s, t and the slopes are in the G_RDPHALF_1 and G_RDPHALF_2 that follow
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "%s(%d, %d, %d, %d, %d, *, *, *, *)",
+        GFX_COMMAND(&command) == (u8)G_TEXRECTFLIP ? "gsSPTextureRectangleFlip" : "gsSPTextureRectangle",
+        RECT_X0(&command),
+        RECT_Y0(&command),
+        RECT_X1(&command),
+        RECT_Y1(&command),
+        RECT_TILE(&command)
+    );
+}
+
+unsigned gfxPrintMicrocodeCommand(const struct GFXMicrocode* microcode, Gfx command, char* output, unsigned maxOutputLen) {
+    GFXCommandPrinter printer = microcode->commands[GFX_COMMAND(&command)].print;
 
     if (printer) {
         return printer(command, output, maxOutputLen);
     } else {
         return gfxUnknownCommandPrinter(command, output, maxOutputLen);
     }
+}
+
+unsigned gfxPrintCommand(Gfx command, char* output, unsigned maxOutputLen) {
+    return gfxPrintMicrocodeCommand(gfxDefaultMicrocode(), command, output, maxOutputLen);
 }
\ No newline at end of file
@@ -2,7 +2,10 @@
 #define _GFX_VALIDATOR_COMMAND_PRINTER_H
 
 #include <ultra64.h>
+#include "microcode.h"
 
+unsigned gfxPrintMicrocodeCommand(const struct GFXMicrocode* microcode, Gfx command, char* output, unsigned maxOutputLen);
+// prints command as encoded by gfxDefaultMicrocode()
 unsigned gfxPrintCommand(Gfx command, char* output, unsigned maxOutputLen);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,48 @@
+
+#include "diagnostics.h"
+
+void gfxDiagnosticLogInit(struct GFXDiagnosticLog* log, struct GFXDiagnostic* entries, u32 capacity) {
+    log->entries = entries;
+    log->capacity = capacity;
+    gfxDiagnosticLogClear(log);
+}
+
+void gfxDiagnosticLogClear(struct GFXDiagnosticLog* log) {
+    log->next = 0;
+    log->total = 0;
+}
+
+struct GFXDiagnostic* gfxDiagnosticLogNext(struct GFXDiagnosticLog* log) {
+    ++log->total;
+
+    if (!log->capacity) {
+        return 0;
+    }
+
+    struct GFXDiagnostic* result = &log->entries[log->next];
+
+    if (++log->next == log->capacity) {
+        log->next = 0;
+    }
+
+    return result;
+}
+
+u32 gfxDiagnosticLogSize(struct GFXDiagnosticLog* log) {
+    return log->total < log->capacity ? log->total : log->capacity;
+}
+
+struct GFXDiagnostic* gfxDiagnosticLogGet(struct GFXDiagnosticLog* log, u32 index) {
+    if (index >= gfxDiagnosticLogSize(log)) {
+        return 0;
+    }
+
+    // once the log wraps the oldest entry is the one written next
+    u32 slot = (log->total < log->capacity ? 0 : log->next) + index;
+
+    if (slot >= log->capacity) {
+        slot -= log->capacity;
+    }
+
+    return &log->entries[slot];
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef _GFX_VALIDATOR_DIAGNOSTICS_H
+#define _GFX_VALIDATOR_DIAGNOSTICS_H
+
+#include "validator.h"
+
+enum GFXDiagnosticSeverity {
+    GFXSeverityWarning,
+    GFXSeverityError,
+};
+
+struct GFXDiagnostic {
+    // location.reason is the error or warning code
+    struct GFXValidationResult location;
+    enum GFXDiagnosticSeverity severity;
+    // physical address of the command that caused it
+    u32 address;
+};
+
+// fixed size ring buffer, once full the oldest diagnostics are overwritten
+struct GFXDiagnosticLog {
+    struct GFXDiagnostic* entries;
+    u32 capacity;
+    // entry the next diagnostic is written to
+    u32 next;
+    // diagnostics reported since the log was cleared, including overwritten
+    // ones
+    u32 total;
+};
+
+void gfxDiagnosticLogInit(struct GFXDiagnosticLog* log, struct GFXDiagnostic* entries, u32 capacity);
+void gfxDiagnosticLogClear(struct GFXDiagnosticLog* log);
+// returns the entry to fill in, 0 if the log has no capacity
+struct GFXDiagnostic* gfxDiagnosticLogNext(struct GFXDiagnosticLog* log);
+// diagnostics still held by the log
+u32 gfxDiagnosticLogSize(struct GFXDiagnosticLog* log);
+// index 0 is the oldest diagnostic still held
+struct GFXDiagnostic* gfxDiagnosticLogGet(struct GFXDiagnosticLog* log, u32 index);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include "disassembler.h"
+#include "command_printer.h"
+#include "diagnostics.h"
+#include "format.h"
+#include "gfx_macros.h"
+
+#define GFX_DISASSEMBLY_INDENT  2
+// enough to hold every diagnostic a single command can report
+#define GFX_DISASSEMBLY_DIAGNOSTICS 4
+
+struct GFXDisassembler {
+    struct GFXOutputBuffer* output;
+    struct GFXDiagnosticLog log;
+    struct GFXDiagnostic entries[GFX_DISASSEMBLY_DIAGNOSTICS];
+    // diagnostics in log that have been printed
+    u32 printed;
+};
+
+void gfxOutputInit(struct GFXOutputBuffer* output, char* data, unsigned capacity, gfxPrinter printer) {
+    output->data = data;
+    output->capacity = capacity;
+    output->length = 0;
+    output->printer = printer;
+}
+
+char* gfxOutputReserve(struct GFXOutputBuffer* output, unsigned length) {
+    if (output->capacity - output->length < length) {
+        gfxOutputFlush(output);
+    }
+
+    return output->data + output->length;
+}
+
+void gfxOutputCommit(struct GFXOutputBuffer* output, unsigned length) {
+    output->length += length;
+}
+
+void gfxOutputFlush(struct GFXOutputBuffer* output) {
+    if (output->length) {
+        output->printer(output->data, output->length);
+        output->length = 0;
+    }
+}
+
+// address in w1 for commands that load memory, segmented
+int gfxCommandAddress(const struct GFXMicrocode* microcode, Gfx* command, u32* address) {
+    switch (GFX_COMMAND_KIND(microcode, command)) {
+        case GFXCommandDL:
+        case GFXCommandVertex:
+        case GFXCommandMtx:
+        case GFXCommandMoveMem:
+            *address = DMA_ADDR(command);
+            return 1;
+    }
+
+    switch (GFX_COMMAND(command)) {
+        case (u8)G_SETCIMG:
+        case (u8)G_SETZIMG:
+        case (u8)G_SETTIMG:
+            *address = DMA_ADDR(command);
+            return 1;
+    }
+
+    return 0;
+}
+
+unsigned gfxIndent(char* output, int depth) {
+    int i;
+
+    for (i = 0; i < depth * GFX_DISASSEMBLY_INDENT; ++i) {
+        output[i] = ' ';
+    }
+
+    return i;
+}
+
+void gfxDisassembleDiagnostics(struct GFXDisassembler* disassembler) {
+    u32 size = gfxDiagnosticLogSize(&disassembler->log);
+    // skips anything overwritten before it was printed
+    u32 index = disassembler->log.total - disassembler->printed;
+
+    index = index < size ? size - index : 0;
+    
+    for (; index < size; ++index) {
+        struct GFXDiagnostic* diagnostic = gfxDiagnosticLogGet(&disassembler->log, index);
+        char* line = gfxOutputReserve(disassembler->output, GFX_MAX_DISASSEMBLY_LINE);
+        unsigned length = gfxIndent(line, diagnostic->location.gfxStackSize - 1);
+
+        length += gfxFormat(
+            line + length, 
+            GFX_MAX_DISASSEMBLY_LINE - length, 
+            "^ %s: ", 
+            diagnostic->severity == GFXSeverityWarning ? "warning" : "error"
+        );
+        length += gfxFormatReason(&diagnostic->location, line + length);
+        line[length++] = '\n';
+
+        gfxOutputCommit(disassembler->output, length);
+    }
+
+    disassembler->printed = disassembler->log.total;
+}
+
+void gfxDisassembleCommand(void* data, struct GFXValidatorState* state, Gfx* command) {
+    struct GFXDisassembler* disassembler = (struct GFXDisassembler*)data;
+    // the previous command finished validating, report what it found
+    gfxDisassembleDiagnostics(disassembler);
+
+    char* line = gfxOutputReserve(disassembler->output, GFX_MAX_DISASSEMBLY_LINE);
+    // leave room for the newline and the null terminator
+    unsigned maxLength = GFX_MAX_DISASSEMBLY_LINE - 1;
+    unsigned length = gfxIndent(line, state->gfxStackSize - 1);
+    u32 address;
+
+    length += gfxFormat(line + length, maxLength - length, "0x%08x: ", state->gfxStack[state->gfxStackSize - 1].address);
+    length += gfxPrintMicrocodeCommand(state->microcode, *command, line + length, maxLength - length);
+
+    if (gfxCommandAddress(state->microcode, command, &address)) {
+        int segment = _SHIFTR(address, 24, 4);
+
+        if (segment && state->pipeline.segments[segment] != SEGMENT_UNINITIALIZED) {
+            length += gfxFormat(line + length, maxLength - length, " // 0x%08x", state->pipeline.segments[segment] + (address & 0xFFFFFF));
+        }
+    }
+
+    line[length++] = '\n';
+    gfxOutputCommit(disassembler->output, length);
+}
+
+enum GFXValidatorError gfxDisassemble(u32 address, int maxGfxCount, struct GFXValidatorOptions* options, struct GFXOutputBuffer* output) {
+    struct GFXDisassembler disassembler;
+    struct GFXValidatorOptions disassembleOptions = *options;
+    struct GFXValidationResult result;
+
+    disassembler.output = output;
+    disassembler.printed = 0;
+    gfxDiagnosticLogInit(&disassembler.log, disassembler.entries, GFX_DISASSEMBLY_DIAGNOSTICS);
+
+    // every command has to be visited so nothing can be skipped by the cache
+    disassembleOptions.cache = 0;
+    disassembleOptions.diagnostics = &disassembler.log;
+    disassembleOptions.visitor = gfxDisassembleCommand;
+    disassembleOptions.visitorData = &disassembler;
+
+    enum GFXValidatorError error = gfxValidateDisplayList(address, maxGfxCount, &disassembleOptions, &result);
+
+    gfxDisassembleDiagnostics(&disassembler);
+
+    // errors that stop validation aren't logged
+    if (error == GFXValidatorCommandLimit || (error != GFXValidatorErrorNone && !disassembler.log.total)) {
+        char* line = gfxOutputReserve(output, GFX_MAX_DISASSEMBLY_LINE);
+        unsigned length = gfxFormat(line, GFX_MAX_DISASSEMBLY_LINE, "^ error: ");
+        length += gfxFormatReason(&result, line + length);
+        line[length++] = '\n';
+        gfxOutputCommit(output, length);
+    }
+
+    gfxOutputFlush(output);
+
+    return error;
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#ifndef _GFX_VALIDATOR_DISASSEMBLER_H
+#define _GFX_VALIDATOR_DISASSEMBLER_H
+
+#include "validator.h"
+
+// longest line gfxDisassemble writes, including the newline
+#define GFX_MAX_DISASSEMBLY_LINE    192
+
+// text is collected in data and handed to printer in blocks as large as the
+// buffer allows, blocks always end on a line break
+struct GFXOutputBuffer {
+    char* data;
+    unsigned capacity;
+    unsigned length;
+    gfxPrinter printer;
+};
+
+// capacity must be at least GFX_MAX_DISASSEMBLY_LINE
+void gfxOutputInit(struct GFXOutputBuffer* output, char* data, unsigned capacity, gfxPrinter printer);
+// returns space for at least length bytes, flushing first if needed
+char* gfxOutputReserve(struct GFXOutputBuffer* output, unsigned length);
+// adds length bytes written to the space returned by gfxOutputReserve
+void gfxOutputCommit(struct GFXOutputBuffer* output, unsigned length);
+void gfxOutputFlush(struct GFXOutputBuffer* output);
+
+// prints every command reached from the display list at address, one per
+// line with the physical address it was read from. called display lists are
+// indented under the command that called them and segmented addresses are
+// followed by the physical address they resolve to. the display list is
+// validated as it is printed, errors and warnings are printed below the
+// command that caused them and validation keeps going where it can.
+// options.diagnostics, options.visitor and options.cache are ignored.
+// returns the first error, output is flushed before returning
+enum GFXValidatorError gfxDisassemble(u32 address, int maxGfxCount, struct GFXValidatorOptions* options, struct GFXOutputBuffer* output);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,42 @@
+
+#include "encoding.h"
+#include "gfx_macros.h"
+
+unsigned char* gfxEncodeWord(unsigned char* output, u32 word) {
+    output[0] = (unsigned char)(word >> 24);
+    output[1] = (unsigned char)(word >> 16);
+    output[2] = (unsigned char)(word >> 8);
+    output[3] = (unsigned char)word;
+    return output + 4;
+}
+
+unsigned gfxEncodeResult(struct GFXValidationResult* result, unsigned char* output) {
+    unsigned char* curr = output;
+    int i;
+
+    curr[0] = 'G';
+    curr[1] = 'V';
+    curr[2] = GFX_ENCODING_VERSION;
+    curr[3] = (unsigned char)result->reason;
+    curr[4] = (unsigned char)(result->reasonId >> 8);
+    curr[5] = (unsigned char)result->reasonId;
+    curr[6] = (unsigned char)result->gfxStackSize;
+    curr[7] = GFX_MAX_REASON_ARGS;
+    curr[8] = result->microcode;
+    curr[9] = 0;
+    curr[10] = 0;
+    curr[11] = 0;
+    curr += GFX_ENCODED_HEADER_SIZE;
+
+    for (i = 0; i < GFX_MAX_REASON_ARGS; ++i) {
+        curr = gfxEncodeWord(curr, result->reasonArgs[i]);
+    }
+
+    for (i = 0; i < result->gfxStackSize; ++i) {
+        curr = gfxEncodeWord(curr, result->gfxStackAddress[i]);
+        curr = gfxEncodeWord(curr, GFX_W0(&result->gfxStack[i]));
+        curr = gfxEncodeWord(curr, GFX_W1(&result->gfxStack[i]));
+    }
+
+    return curr - output;
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#ifndef _GFX_VALIDATOR_ENCODING_H
+#define _GFX_VALIDATOR_ENCODING_H
+
+#include "validator.h"
+
+// compact big endian form of a GFXValidationResult for sending to a host
+// without formatting anything on the console
+//
+//   0   'G' 'V' GFX_ENCODING_VERSION reason
+//   4   reasonId (16 bit) stackSize argCount
+//   8   microcode 0 0 0
+//   12  argCount 32 bit reason arguments
+//       stackSize entries of address, w0, w1 each 32 bit
+#define GFX_ENCODING_VERSION        2
+#define GFX_ENCODED_HEADER_SIZE     12
+#define GFX_ENCODED_STACK_ENTRY     12
+#define GFX_MAX_ENCODED_RESULT      (GFX_ENCODED_HEADER_SIZE + GFX_MAX_REASON_ARGS * 4 + GFX_MAX_GFX_STACK * GFX_ENCODED_STACK_ENTRY)
+
+// writes word big endian, returns output + 4
+unsigned char* gfxEncodeWord(unsigned char* output, u32 word);
+
+// output must hold GFX_MAX_ENCODED_RESULT bytes, returns the bytes written
+unsigned gfxEncodeResult(struct GFXValidationResult* result, unsigned char* output);
+
+#endif
\ No newline at end of file
@@ -1,36 +1,53 @@
 
 #include "./command_printer.h"
 #include "./validator.h"
+#include "./format.h"
 #include <string.h>
 
-#define TMP_BUFFER_SIZE 64
+#define TMP_BUFFER_SIZE 128
 
 typedef unsigned (*ErrorPrinter)(struct GFXValidationResult* result, char* output, unsigned maxOutputLen);
 
+unsigned gfxFormatReason(struct GFXValidationResult* result, char* output) {
+    if (result->reasonId >= GFXReasonCount) {
+        return gfxFormat(output, GFX_MAX_REASON_LENGTH, "unknown reason %d", result->reasonId);
+    }
+
+    return gfxFormat(
+        output, 
+        GFX_MAX_REASON_LENGTH,
+        gfxReasonFormats[result->reasonId], 
+        (unsigned)result->reasonArgs[0], 
+        (unsigned)result->reasonArgs[1], 
+        (unsigned)result->reasonArgs[2]
+    );
+}
+
 void gfxGenerateReadableMessage(struct GFXValidationResult* result, gfxPrinter printer) {
     char tmpBuffer[TMP_BUFFER_SIZE];
 
     if (result->reason == GFXValidatorErrorNone) {
-        printer(tmpBuffer, sprintf(tmpBuffer, "success"));
+        printer(tmpBuffer, gfxFormat(tmpBuffer, TMP_BUFFER_SIZE, "success"));
         return;
     }
 
+    const struct GFXMicrocode* microcode = result->microcode < GFXMicrocodeCount ? gfxMicrocodes[result->microcode] : gfxDefaultMicrocode();
+
     for (int i = 0; i < result->gfxStackSize; ++i) {
         char* curr = tmpBuffer;
         unsigned currOffset = 0;
-        currOffset += sprintf(curr + currOffset, "0x%08x: ", (unsigned)result->gfxStack[i]);
-        currOffset += gfxPrintCommand(*result->gfxStack[i], curr + currOffset, (unsigned)(TMP_BUFFER_SIZE - currOffset));
-
-        if (currOffset < TMP_BUFFER_SIZE) {
-            curr[currOffset++] = '\n';
-        }
+        // leave room for the newline and null terminator
+        currOffset += gfxFormat(curr + currOffset, TMP_BUFFER_SIZE - 1, "0x%08x: ", (unsigned)result->gfxStackAddress[i]);
+        currOffset += gfxPrintMicrocodeCommand(microcode, result->gfxStack[i], curr + currOffset, (unsigned)(TMP_BUFFER_SIZE - 1 - currOffset));
 
+        curr[currOffset++] = '\n';
         curr[currOffset] = '\0';
 
         printer(tmpBuffer, currOffset);
     }
 
-    if (result->reasonMessage[0]) {
-        printer(result->reasonMessage, strlen(result->reasonMessage));
+    if (result->reasonId != GFXReasonNone) {
+        char reasonBuffer[GFX_MAX_REASON_LENGTH];
+        printer(reasonBuffer, gfxFormatReason(result, reasonBuffer));
     }
 }
\ No newline at end of file
@@ -0,0 +1,130 @@
+
+#include "format.h"
+
+struct GFXFormatOutput {
+    char* output;
+    unsigned length;
+    // not counting the null terminator
+    unsigned maxLength;
+};
+
+void gfxFormatChar(struct GFXFormatOutput* output, char c) {
+    if (output->length < output->maxLength) {
+        output->output[output->length++] = c;
+    }
+}
+
+void gfxFormatNumber(struct GFXFormatOutput* output, unsigned value, unsigned base, int uppercase, int negative, int width, char pad) {
+    // enough digits for a 32 bit number in base 8 or higher
+    char digits[12];
+    int digitCount = 0;
+    const char* digitChars = uppercase ? "0123456789ABCDEF" : "0123456789abcdef";
+
+    do {
+        digits[digitCount++] = digitChars[value % base];
+        value /= base;
+    } while (value);
+
+    width -= digitCount + negative;
+
+    if (negative && pad == '0') {
+        gfxFormatChar(output, '-');
+    }
+
+    for (; width > 0; --width) {
+        gfxFormatChar(output, pad);
+    }
+
+    if (negative && pad != '0') {
+        gfxFormatChar(output, '-');
+    }
+
+    while (digitCount) {
+        gfxFormatChar(output, digits[--digitCount]);
+    }
+}
+
+unsigned gfxFormatV(char* output, unsigned maxOutputLen, const char* format, va_list args) {
+    struct GFXFormatOutput result;
+
+    if (!maxOutputLen) {
+        return 0;
+    }
+
+    result.output = output;
+    result.length = 0;
+    result.maxLength = maxOutputLen - 1;
+
+    for (; *format; ++format) {
+        if (*format != '%') {
+            gfxFormatChar(&result, *format);
+            continue;
+        }
+
+        ++format;
+
+        char pad = ' ';
+        int width = 0;
+
+        if (*format == '0') {
+            pad = '0';
+            ++format;
+        }
+
+        while (*format >= '0' && *format <= '9') {
+            width = width * 10 + *format - '0';
+            ++format;
+        }
+
+        switch (*format) {
+            case 'd':
+            case 'i':
+                {
+                    int value = va_arg(args, int);
+                    gfxFormatNumber(&result, value < 0 ? -(unsigned)value : (unsigned)value, 10, 0, value < 0, width, pad);
+                }
+                break;
+            case 'u':
+                gfxFormatNumber(&result, va_arg(args, unsigned), 10, 0, 0, width, pad);
+                break;
+            case 'x':
+            case 'X':
+                gfxFormatNumber(&result, va_arg(args, unsigned), 16, *format == 'X', 0, width, pad);
+                break;
+            case 'c':
+                gfxFormatChar(&result, (char)va_arg(args, int));
+                break;
+            case 's':
+                {
+                    const char* str = va_arg(args, const char*);
+
+                    while (*str) {
+                        gfxFormatChar(&result, *str++);
+                    }
+                }
+                break;
+            case '%':
+                gfxFormatChar(&result, '%');
+                break;
+            case '\0':
+                --format;
+                break;
+            default:
+                gfxFormatChar(&result, '%');
+                gfxFormatChar(&result, *format);
+                break;
+        }
+    }
+
+    output[result.length] = '\0';
+
+    return result.length;
+}
+
+unsigned gfxFormat(char* output, unsigned maxOutputLen, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    unsigned result = gfxFormatV(output, maxOutputLen, format, args);
+    va_end(args);
+    return result;
+}
\ No newline at end of file
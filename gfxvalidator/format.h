@@ -0,0 +1,12 @@
+#ifndef _GFX_VALIDATOR_FORMAT_H
+#define _GFX_VALIDATOR_FORMAT_H
+
+#include <stdarg.h>
+
+// a bounded subset of sprintf that never writes more than maxOutputLen bytes
+// including the null terminator. supports %d %i %u %x %X %c %s and %% with
+// an optional 0 flag and width. returns the number of characters written
+unsigned gfxFormat(char* output, unsigned maxOutputLen, const char* format, ...);
+unsigned gfxFormatV(char* output, unsigned maxOutputLen, const char* format, va_list args);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,267 @@
+
+#include "validator_internal.h"
+#include "gfx_macros.h"
+
+// color and depth images must start on a 64 byte boundary
+#define IMAGE_ALIGNMENT     64
+
+#define RECT_X(word)        _SHIFTR(word, 12, 12)
+#define RECT_Y(word)        _SHIFTR(word, 0, 12)
+
+u32 gfxImageRowBytes(struct GFXImage* image) {
+    return ((u32)image->width << image->size) >> 1;
+}
+
+// bytes from the start of the image to the end of the row containing y
+u32 gfxImageExtent(struct GFXImage* image, int y) {
+    return gfxImageRowBytes(image) * (y + 1);
+}
+
+enum GFXValidatorError gfxSetImage(struct GFXValidatorState* state, struct GFXImage* image, Gfx* at) {
+    int translated;
+    // only the first row, the scissor and rectangles check the rest
+    enum GFXValidatorError result = gfxValidateAddress(state, DMA_ADDR(at), ((_SHIFTR(GFX_W0(at), 0, 12) + 1) << _SHIFTR(GFX_W0(at), 19, 2)) >> 1, IMAGE_ALIGNMENT);
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    gfxTranslateAddress(state, DMA_ADDR(at), &translated);
+
+    image->address = translated & 0xFFFFFFF;
+    image->format = _SHIFTR(GFX_W0(at), 21, 3);
+    image->size = _SHIFTR(GFX_W0(at), 19, 2);
+    image->width = _SHIFTR(GFX_W0(at), 0, 12) + 1;
+    state->pipeline.flags |= GFX_RENDER_TARGET_DIRTY;
+
+    return GFXValidatorErrorNone;
+}
+
+enum GFXValidatorError gfxValidateSetColorImageCheap(struct GFXValidatorState* state, Gfx* at) {
+    int size = _SHIFTR(GFX_W0(at), 19, 2);
+
+    if (size == G_IM_SIZ_4b) {
+        gfxSetReason(state, GFXReasonColorImage4Bit);
+        return GFXValidatorInvalidArguments;
+    }
+
+    state->pipeline.flags |= GFX_INITIALIZED_CIMG;
+
+    return gfxSetImage(state, &state->pipeline.colorImage, at);
+}
+
+enum GFXValidatorError gfxValidateSetDepthImageCheap(struct GFXValidatorState* state, Gfx* at) {
+    state->pipeline.flags |= GFX_INITIALIZED_ZIMG;
+
+    return gfxSetImage(state, &state->pipeline.depthImage, at);
+}
+
+enum GFXValidatorError gfxValidateSetScissor(struct GFXValidatorState* state, Gfx* at) {
+    struct GFXRect* scissor = &state->pipeline.scissor;
+
+    scissor->ulx = RECT_X(GFX_W0(at));
+    scissor->uly = RECT_Y(GFX_W0(at));
+    scissor->lrx = RECT_X(GFX_W1(at));
+    scissor->lry = RECT_Y(GFX_W1(at));
+
+    if (scissor->lrx < scissor->ulx || scissor->lry < scissor->uly) {
+        gfxSetReason(state, GFXReasonScissorNegative);
+        return GFXValidatorInvalidArguments;
+    }
+
+    state->pipeline.flags |= GFX_INITIALIZED_SCISSOR | GFX_RENDER_TARGET_DIRTY;
+
+    return GFXValidatorErrorNone;
+}
+
+// every rectangle command has the lower right corner in w0 and the upper
+// left in w1
+enum GFXValidatorError gfxValidateRectCheap(struct GFXValidatorState* state, Gfx* at) {
+    if (RECT_X(GFX_W0(at)) < RECT_X(GFX_W1(at)) || RECT_Y(GFX_W0(at)) < RECT_Y(GFX_W1(at))) {
+        gfxSetReason(state, GFXReasonRectNegative);
+        return GFXValidatorInvalidArguments;
+    }
+
+    return GFXValidatorErrorNone;
+}
+
+#ifndef GFX_DISABLE_STANDARD_VALIDATION
+
+// checks that rows [0, y] of the color image are in RAM and x is inside of it
+enum GFXValidatorError gfxCheckColorImageBounds(struct GFXValidatorState* state, enum GFXReason widthReason, enum GFXReason ramReason, int x, int y) {
+    struct GFXImage* image = &state->pipeline.colorImage;
+
+    if (x >= image->width) {
+        gfxSetReason(state, widthReason, x, image->width);
+        return GFXValidatorInvalidArguments;
+    }
+
+    if (gfxImageExtent(image, y) > state->memory->size - image->address) {
+        gfxSetReason(state, ramReason, y);
+        return GFXValidatorInvalidArguments;
+    }
+
+    return gfxCheckRegion(state, image->address, image->address, gfxImageExtent(image, y));
+}
+
+// lazily checks the combination of color image, depth image, scissor and
+// othermode, only runs again once one of them changes
+enum GFXValidatorError gfxCheckRenderTarget(struct GFXValidatorState* state) {
+    struct GFXPipelineState* pipeline = &state->pipeline;
+
+    if (!(pipeline->flags & GFX_INITIALIZED_CIMG)) {
+        gfxSetReason(state, GFXReasonNoColorImage);
+        return GFXValidatorUnitialized;
+    }
+
+    if (!(pipeline->flags & GFX_RENDER_TARGET_DIRTY)) {
+        return GFXValidatorErrorNone;
+    }
+
+    if (pipeline->othermodeL & (Z_CMP | Z_UPD)) {
+        if (!(pipeline->flags & GFX_INITIALIZED_ZIMG)) {
+            gfxSetReason(state, GFXReasonNoDepthImage);
+            return GFXValidatorUnitialized;
+        }
+
+        // the scissor is the only bound on the rows triangles can cover, so
+        // without one the depth image can't be checked against the color
+        // image or the end of RAM
+        if (!(pipeline->flags & GFX_INITIALIZED_SCISSOR)) {
+            gfxSetReason(state, GFXReasonNoScissor);
+            return GFXValidatorUnitialized;
+        }
+
+        // the depth buffer shares the width of the color image and is 16 bit
+        int lastRow = (pipeline->scissor.lry >> 2) - 1;
+        u32 colorEnd = pipeline->colorImage.address + gfxImageExtent(&pipeline->colorImage, lastRow);
+        u32 depthEnd = pipeline->depthImage.address + pipeline->colorImage.width * 2 * (lastRow + 1);
+
+        if (pipeline->colorImage.address < depthEnd && pipeline->depthImage.address < colorEnd) {
+            gfxSetReason(state, GFXReasonDepthOverlapsColor, pipeline->depthImage.address, pipeline->colorImage.address);
+            return GFXValidatorInvalidArguments;
+        }
+
+        if (depthEnd > state->memory->size) {
+            gfxSetReason(state, GFXReasonDepthPastRAM, pipeline->depthImage.address);
+            return GFXValidatorInvalidArguments;
+        }
+    }
+
+    if (pipeline->flags & GFX_INITIALIZED_SCISSOR) {
+        enum GFXValidatorError result = gfxCheckColorImageBounds(state, GFXReasonScissorPastWidth, GFXReasonScissorPastRAM, (pipeline->scissor.lrx >> 2) - 1, (pipeline->scissor.lry >> 2) - 1);
+
+        if (result != GFXValidatorErrorNone) {
+            return result;
+        }
+    }
+
+    pipeline->flags &= ~GFX_RENDER_TARGET_DIRTY;
+
+    return GFXValidatorErrorNone;
+}
+
+enum GFXValidatorError gfxValidateSetColorImage(struct GFXValidatorState* state, Gfx* at) {
+    enum GFXValidatorError result = gfxCheckPipeSync(state);
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    return gfxValidateSetColorImageCheap(state, at);
+}
+
+enum GFXValidatorError gfxValidateSetDepthImage(struct GFXValidatorState* state, Gfx* at) {
+    enum GFXValidatorError result = gfxCheckPipeSync(state);
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    return gfxValidateSetDepthImageCheap(state, at);
+}
+
+// rectangles are clipped to the scissor so only the visible part has to fit
+// in the color image. lrx and lry are exclusive unless inclusive is set,
+// tiles has a bit per tile the rectangle samples
+enum GFXValidatorError gfxCheckRect(struct GFXValidatorState* state, int ulx, int uly, int lrx, int lry, int inclusive, int tiles) {
+    // display lists validated on their own may draw into a color image
+    // bound by whoever calls them, like triangles in gfxCheckDraw
+    int hasColorImage = state->pipeline.flags & GFX_INITIALIZED_CIMG;
+
+    if (hasColorImage) {
+        enum GFXValidatorError result = gfxCheckRenderTarget(state);
+
+        if (result != GFXValidatorErrorNone) {
+            return result;
+        }
+    }
+
+    if (lrx < ulx || lry < uly) {
+        gfxSetReason(state, GFXReasonRectNegative);
+        return GFXValidatorInvalidArguments;
+    }
+
+    gfxRecordPrimitive(state, tiles);
+
+    if (!hasColorImage) {
+        return GFXValidatorErrorNone;
+    }
+
+    if (state->pipeline.flags & GFX_INITIALIZED_SCISSOR) {
+        struct GFXRect* scissor = &state->pipeline.scissor;
+        // fill and copy rectangles include the lower right edge
+        int edge = inclusive ? 4 : 0;
+
+        if (lrx + edge > scissor->lrx) {
+            lrx = scissor->lrx - edge;
+        }
+
+        if (lry + edge > scissor->lry) {
+            lry = scissor->lry - edge;
+        }
+
+        if (lrx < scissor->ulx || lry < scissor->uly || lrx < ulx || lry < uly) {
+            // clipped away completely
+            return GFXValidatorErrorNone;
+        }
+    }
+
+    if (!inclusive) {
+        lrx -= 4;
+        lry -= 4;
+    }
+
+    return gfxCheckColorImageBounds(state, GFXReasonRectPastWidth, GFXReasonRectPastRAM, lrx >> 2, lry >> 2);
+}
+
+int gfxIsInclusiveRect(struct GFXValidatorState* state) {
+    int cycleType = state->pipeline.othermodeH & (3 << G_MDSFT_CYCLETYPE);
+    return cycleType == G_CYC_FILL || cycleType == G_CYC_COPY;
+}
+
+enum GFXValidatorError gfxValidateFillRect(struct GFXValidatorState* state, Gfx* at) {
+    return gfxCheckRect(
+        state, 
+        RECT_X(GFX_W1(at)), 
+        RECT_Y(GFX_W1(at)), 
+        RECT_X(GFX_W0(at)), 
+        RECT_Y(GFX_W0(at)),
+        gfxIsInclusiveRect(state),
+        0
+    );
+}
+
+enum GFXValidatorError gfxValidateTextureRect(struct GFXValidatorState* state, Gfx* at) {
+    return gfxCheckRect(
+        state, 
+        RECT_X(GFX_W1(at)), 
+        RECT_Y(GFX_W1(at)), 
+        RECT_X(GFX_W0(at)), 
+        RECT_Y(GFX_W0(at)),
+        gfxIsInclusiveRect(state),
+        1 << _SHIFTR(GFX_W1(at), 24, 3)
+    );
+}
+
+#endif
\ No newline at end of file
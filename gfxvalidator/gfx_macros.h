@@ -3,22 +3,66 @@
 
 #define SEGMENT_UNINITIALIZED   -1
 
-#define DMA1_LEN(gfx)       _SHIFTR((gfx)->words.w0, 0, 16)
-#define DMA1_PARAM(gfx)     _SHIFTR((gfx)->words.w0, 16, 8)
+// display lists are stored big endian in RDRAM, a little endian host
+// reading a snapshot has to swap each word as it is read
+#if defined(GFX_HOST) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define GFX_WORD(word)      __builtin_bswap32(word)
+#else
+#define GFX_WORD(word)      (word)
+#endif
+
+#define GFX_W0(gfx)         GFX_WORD((gfx)->words.w0)
+#define GFX_W1(gfx)         GFX_WORD((gfx)->words.w1)
+#define GFX_COMMAND(gfx)    _SHIFTR(GFX_W0(gfx), 24, 8)
+
+#define DMA1_LEN(gfx)       _SHIFTR(GFX_W0(gfx), 0, 16)
+#define DMA1_PARAM(gfx)     _SHIFTR(GFX_W0(gfx), 16, 8)
+#define DMA_ADDR(gfx)       GFX_W1(gfx)
+
+// residency bit for the vertex buffer slot a triangle index refers to
+#define VERTEX_SLOT_BIT(index)  (1u << ((index) / VERTEX_INDEX_SCALE))
+
+#define TEXTURE_TILE(gfx)   _SHIFTR(GFX_W0(gfx), 8, 3)
+#define TEXTURE_LEVEL(gfx)  _SHIFTR(GFX_W0(gfx), 11, 3)
+
+// light slots in GFXPipelineState.loadedLights, slot GFX_FIRST_LIGHT_SLOT + n
+// is light n + 1, the ambient light follows the directional lights
+#define GFX_LOOKAT_X_SLOT       0
+#define GFX_LOOKAT_Y_SLOT       1
+#define GFX_FIRST_LIGHT_SLOT    2
+#define GFX_LIGHT_SLOT_COUNT    10
+#define GFX_MAX_LIGHTS          7
 
+// offsets into OSTask_t as laid out in RDRAM
+#define GFX_TASK_TYPE_OFFSET        0x00
+#define GFX_TASK_DATA_PTR_OFFSET    0x30
+#define GFX_TASK_SIZE               0x40
+
+// these decode the microcode selected with F3DEX_GBI_2 so they only mean
+// anything inside microcode_commands.h, everything else has to go through
+// struct GFXMicrocode
 #ifdef F3DEX_GBI_2
-#define DMA_MM_LEN(gfx)     _SHIFTR((gfx)->words.w0, 19, 5)
-#define DMA_MM_OFS(gfx)     (_SHIFTR((gfx)->words.w0, 8, 8) * 8)
-#define DMA_MM_IDX(gfx)     _SHIFTR((gfx)->words.w0, 0, 8)
+#define DMA_MM_LEN(gfx)     _SHIFTR(GFX_W0(gfx), 19, 5)
+#define DMA_MM_OFS(gfx)     (_SHIFTR(GFX_W0(gfx), 8, 8) * 8)
+#define DMA_MM_IDX(gfx)     _SHIFTR(GFX_W0(gfx), 0, 8)
 
 #define DMA_MM_EXPECTED_SIZE(actualSize)    (((actualSize) - 1) >> 3)
+#define DMA_MM_BYTES(gfx)   ((DMA_MM_LEN(gfx) + 1) << 3)
+
+#define MOVE_WORD_IDX(gfx)  _SHIFTR(GFX_W0(gfx), 16, 8)
+#define MOVE_WORD_OFS(gfx)  _SHIFTR(GFX_W0(gfx), 0, 16)
+#define MOVE_WORD_DATA(gfx) GFX_W1(gfx)
+
+#define NUM_LIGHTS(data)    ((data) / 24)
+
+#define TEXTURE_ON(gfx)     _SHIFTR(GFX_W0(gfx), 1, 7)
 
-#define MOVE_WORD_IDX(gfx)  _SHIFTR((gfx)->words.w0, 16, 8)
-#define MOVE_WORD_OFS(gfx)  _SHIFTR((gfx)->words.w0, 0, 16)
-#define MOVE_WORD_DATA(gfx) ((gfx)->words.w1)
+#define OTHERMODE_LEN(gfx)  (_SHIFTR(GFX_W0(gfx), 0, 8) + 1)
+#define OTHERMODE_SFT(gfx)  (32 - _SHIFTR(GFX_W0(gfx), 8, 8) - OTHERMODE_LEN(gfx))
 
 #define VERTEX_BUFFER_SIZE  32
-#define MAX_VERTEX_VALUE    (VERTEX_BUFFER_SIZE * 2)
+#define VERTEX_INDEX_SCALE  2
+#define MAX_VERTEX_VALUE    (VERTEX_BUFFER_SIZE * VERTEX_INDEX_SCALE)
 
 #else
 #define DMA_MM_LEN(gfx)     DMA1_LEN(gfx)
@@ -26,13 +70,22 @@
 #define DMA_MM_IDX(gfx)     DMA1_PARAM(gfx)
 
 #define DMA_MM_EXPECTED_SIZE(actualSize)    (actualSize)
+#define DMA_MM_BYTES(gfx)   DMA_MM_LEN(gfx)
+
+#define MOVE_WORD_IDX(gfx)  _SHIFTR(GFX_W0(gfx), 0, 8)
+#define MOVE_WORD_OFS(gfx)  _SHIFTR(GFX_W0(gfx), 8, 16)
+#define MOVE_WORD_DATA(gfx) GFX_W1(gfx)
+
+#define NUM_LIGHTS(data)    ((((data) & 0x7FFFFFFF) >> 5) - 1)
+
+#define TEXTURE_ON(gfx)     _SHIFTR(GFX_W0(gfx), 0, 8)
 
-#define MOVE_WORD_IDX(gfx)  _SHIFTR((gfx)->words.w0, 0, 8)
-#define MOVE_WORD_OFS(gfx)  _SHIFTR((gfx)->words.w0, 8, 16)
-#define MOVE_WORD_DATA(gfx) ((gfx)->words.w1)
+#define OTHERMODE_LEN(gfx)  _SHIFTR(GFX_W0(gfx), 0, 8)
+#define OTHERMODE_SFT(gfx)  _SHIFTR(GFX_W0(gfx), 8, 8)
 
 #define VERTEX_BUFFER_SIZE  16
-#define MAX_VERTEX_VALUE    (VERTEX_BUFFER_SIZE * 10)
+#define VERTEX_INDEX_SCALE  10
+#define MAX_VERTEX_VALUE    (VERTEX_BUFFER_SIZE * VERTEX_INDEX_SCALE)
 
 #endif
 
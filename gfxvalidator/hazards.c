@@ -0,0 +1,163 @@
+
+#include "hazards.h"
+
+#define HAZARD_ADDRESS(address)     ((address) & 0x1FFFFFFF)
+#define LINES_PER_PAGE              (1 << (GFX_HAZARD_PAGE_SHIFT - GFX_HAZARD_LINE_SHIFT))
+
+u32 gfxHazardBitMask(u32 from, u32 count) {
+    return (count == 32 ? 0xFFFFFFFF : ((1u << count) - 1)) << from;
+}
+
+// sets bits [from, to)
+void gfxHazardSetBits(u32* bits, u32 from, u32 to) {
+    while (from < to) {
+        u32 shift = from & 31;
+        u32 count = to - from < 32 - shift ? to - from : 32 - shift;
+        bits[from >> 5] |= gfxHazardBitMask(shift, count);
+        from += count;
+    }
+}
+
+int gfxHazardAnyBits(u32* bits, u32 from, u32 to) {
+    while (from < to) {
+        u32 shift = from & 31;
+        u32 count = to - from < 32 - shift ? to - from : 32 - shift;
+
+        if (bits[from >> 5] & gfxHazardBitMask(shift, count)) {
+            return 1;
+        }
+
+        from += count;
+    }
+
+    return 0;
+}
+
+// clips [address, address + length) to tracked memory, returns 0 if nothing
+// is left
+int gfxHazardRange(struct GFXHazardMap* map, u32 address, u32 length, u32* start, u32* end) {
+    *start = HAZARD_ADDRESS(address);
+
+    if (*start >= map->memorySize || length == 0) {
+        return 0;
+    }
+
+    *end = length > map->memorySize - *start ? map->memorySize : *start + length;
+    return 1;
+}
+
+void gfxHazardMapInit(struct GFXHazardMap* map, u32* lines, u32 memorySize) {
+    u32 i;
+
+    map->lines = lines;
+    map->memorySize = memorySize < GFX_HAZARD_MAX_MEMORY ? memorySize : GFX_HAZARD_MAX_MEMORY;
+    map->onHazard = 0;
+    map->hazardData = 0;
+
+    for (i = 0; i < GFX_HAZARD_PAGE_WORDS; ++i) {
+        map->pages[i] = 0;
+    }
+
+    for (i = 0; i < GFX_HAZARD_LINE_WORDS(map->memorySize); ++i) {
+        lines[i] = 0;
+    }
+}
+
+void gfxHazardMapClear(struct GFXHazardMap* map) {
+    u32 page;
+    u32 i;
+
+    // only the pages that were marked have line bits to clear
+    for (page = 0; page < GFX_HAZARD_PAGE_WORDS * 32; ++page) {
+        if (map->pages[page >> 5] & (1u << (page & 31))) {
+            for (i = page * LINES_PER_PAGE / 32; i < (page + 1) * LINES_PER_PAGE / 32; ++i) {
+                map->lines[i] = 0;
+            }
+        }
+    }
+
+    for (i = 0; i < GFX_HAZARD_PAGE_WORDS; ++i) {
+        map->pages[i] = 0;
+    }
+}
+
+void gfxHazardMark(struct GFXHazardMap* map, u32 address, u32 length) {
+    u32 start;
+    u32 end;
+
+    if (!gfxHazardRange(map, address, length, &start, &end)) {
+        return;
+    }
+
+    gfxHazardSetBits(map->lines, start >> GFX_HAZARD_LINE_SHIFT, ((end - 1) >> GFX_HAZARD_LINE_SHIFT) + 1);
+    gfxHazardSetBits(map->pages, start >> GFX_HAZARD_PAGE_SHIFT, ((end - 1) >> GFX_HAZARD_PAGE_SHIFT) + 1);
+}
+
+int gfxHazardCheck(struct GFXHazardMap* map, u32 address, u32 length) {
+    u32 start;
+    u32 end;
+    u32 page;
+
+    if (!gfxHazardRange(map, address, length, &start, &end)) {
+        return 0;
+    }
+
+    for (page = start >> GFX_HAZARD_PAGE_SHIFT; page <= (end - 1) >> GFX_HAZARD_PAGE_SHIFT; ++page) {
+        if (!(map->pages[page >> 5] & (1u << (page & 31)))) {
+            continue;
+        }
+
+        u32 pageStart = page << GFX_HAZARD_PAGE_SHIFT;
+        u32 pageEnd = pageStart + (1 << GFX_HAZARD_PAGE_SHIFT);
+        u32 from = start > pageStart ? start : pageStart;
+        u32 to = end < pageEnd ? end : pageEnd;
+
+        if (gfxHazardAnyBits(map->lines, from >> GFX_HAZARD_LINE_SHIFT, ((to - 1) >> GFX_HAZARD_LINE_SHIFT) + 1)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int gfxHazardWrite(struct GFXHazardMap* map, u32 address, u32 length) {
+    if (!gfxHazardCheck(map, address, length)) {
+        return 0;
+    }
+
+    if (map->onHazard) {
+        map->onHazard(map->hazardData, address, length);
+    }
+
+    return 1;
+}
+
+int gfxHazardNextRange(struct GFXHazardMap* map, u32 address, u32* start, u32* end) {
+    u32 lineCount = map->memorySize >> GFX_HAZARD_LINE_SHIFT;
+    u32 line = (HAZARD_ADDRESS(address) + (1 << GFX_HAZARD_LINE_SHIFT) - 1) >> GFX_HAZARD_LINE_SHIFT;
+
+    while (line < lineCount && !(map->lines[line >> 5] & (1u << (line & 31)))) {
+        u32 page = line >> (GFX_HAZARD_PAGE_SHIFT - GFX_HAZARD_LINE_SHIFT);
+
+        if (!(map->pages[page >> 5] & (1u << (page & 31)))) {
+            line = (page + 1) * LINES_PER_PAGE;
+        } else if (!map->lines[line >> 5]) {
+            line = (line | 31) + 1;
+        } else {
+            ++line;
+        }
+    }
+
+    if (line >= lineCount) {
+        return 0;
+    }
+
+    *start = line << GFX_HAZARD_LINE_SHIFT;
+
+    while (line < lineCount && (map->lines[line >> 5] & (1u << (line & 31)))) {
+        ++line;
+    }
+
+    *end = line << GFX_HAZARD_LINE_SHIFT;
+    return 1;
+}
\ No newline at end of file
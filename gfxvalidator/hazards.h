@@ -0,0 +1,48 @@
+#ifndef _GFX_VALIDATOR_HAZARDS_H
+#define _GFX_VALIDATOR_HAZARDS_H
+
+#include <ultra64.h>
+
+// memory is tracked in data cache lines with a bit per page on top so
+// clearing the map and checking large writes skip pages the task never reads
+#define GFX_HAZARD_LINE_SHIFT   4
+#define GFX_HAZARD_PAGE_SHIFT   12
+#define GFX_HAZARD_MAX_MEMORY   0x800000
+
+#define GFX_HAZARD_PAGE_WORDS   (GFX_HAZARD_MAX_MEMORY >> (GFX_HAZARD_PAGE_SHIFT + 5))
+// size of the lines array needed to track memorySize bytes, in u32s
+#define GFX_HAZARD_LINE_WORDS(memorySize)   (((memorySize) + (1 << (GFX_HAZARD_LINE_SHIFT + 5)) - 1) >> (GFX_HAZARD_LINE_SHIFT + 5))
+
+// called with the write that touched memory the task still reads
+typedef void (*GFXHazardCallback)(void* data, u32 address, u32 length);
+
+// the memory a task reads while it runs, filled in by validating the task
+// with GFXValidatorOptions.hazards set and cleared once the task is done.
+// one map is needed for each task in flight
+struct GFXHazardMap {
+    u32 pages[GFX_HAZARD_PAGE_WORDS];
+    u32* lines;
+    u32 memorySize;
+    // optional, called by gfxHazardWrite
+    GFXHazardCallback onHazard;
+    void* hazardData;
+};
+
+// lines holds GFX_HAZARD_LINE_WORDS(memorySize) words
+void gfxHazardMapInit(struct GFXHazardMap* map, u32* lines, u32 memorySize);
+// forgets everything marked, call once the task has finished
+void gfxHazardMapClear(struct GFXHazardMap* map);
+
+// addresses can be physical or in KSEG0, anything past memorySize is ignored
+void gfxHazardMark(struct GFXHazardMap* map, u32 address, u32 length);
+// returns 1 if any cache line of [address, address + length) is read by
+// the task
+int gfxHazardCheck(struct GFXHazardMap* map, u32 address, u32 length);
+// write barrier, call before the CPU writes to memory that may still be in
+// use. returns 1 and calls onHazard if the task reads any of it
+int gfxHazardWrite(struct GFXHazardMap* map, u32 address, u32 length);
+// finds the first run of marked cache lines at or after address, returns 0
+// if there isn't one
+int gfxHazardNextRange(struct GFXHazardMap* map, u32 address, u32* start, u32* end);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,97 @@
+
+#include "batch.h"
+#include "rdram_snapshot.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#define GFX_MAX_BATCH_THREADS   256
+
+struct GFXBatch {
+    struct GFXBatchJob* jobs;
+    int jobCount;
+    int nextJob;
+};
+
+void gfxRunBatchJob(struct GFXBatchJob* job) {
+    struct GFXRDRAMSnapshot snapshot;
+
+    if (gfxSnapshotOpen(&snapshot, job->snapshotPath) != 0) {
+        job->openError = errno ? errno : EINVAL;
+        job->error = GFXValidatorErrorNone;
+        job->result.gfxStackSize = 0;
+        job->result.reason = GFXValidatorErrorNone;
+        job->result.reasonId = GFXReasonNone;
+        return;
+    }
+
+    struct GFXValidatorOptions options = {0};
+    options.memory = &snapshot.memory;
+    options.microcode = job->microcode;
+
+    job->openError = 0;
+    job->error = gfxValidateTaskAt(job->taskAddress, job->maxGfxCount, &options, &job->result);
+
+    gfxSnapshotClose(&snapshot);
+}
+
+void* gfxBatchWorker(void* data) {
+    struct GFXBatch* batch = data;
+
+    for (;;) {
+        int jobIndex = __atomic_fetch_add(&batch->nextJob, 1, __ATOMIC_RELAXED);
+
+        if (jobIndex >= batch->jobCount) {
+            return 0;
+        }
+
+        gfxRunBatchJob(&batch->jobs[jobIndex]);
+    }
+}
+
+int gfxValidateBatch(struct GFXBatchJob* jobs, int jobCount, int threadCount) {
+    pthread_t threads[GFX_MAX_BATCH_THREADS];
+    struct GFXBatch batch;
+    int startedThreads = 0;
+    int failed = 0;
+    int i;
+
+    batch.jobs = jobs;
+    batch.jobCount = jobCount;
+    batch.nextJob = 0;
+
+    if (threadCount <= 0) {
+        threadCount = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+
+    if (threadCount > jobCount) {
+        threadCount = jobCount;
+    }
+
+    if (threadCount > GFX_MAX_BATCH_THREADS) {
+        threadCount = GFX_MAX_BATCH_THREADS;
+    }
+
+    // the calling thread works too so the batch still finishes if no
+    // threads could be started
+    for (i = 1; i < threadCount; ++i) {
+        if (pthread_create(&threads[startedThreads], 0, gfxBatchWorker, &batch) == 0) {
+            ++startedThreads;
+        }
+    }
+
+    gfxBatchWorker(&batch);
+
+    for (i = 0; i < startedThreads; ++i) {
+        pthread_join(threads[i], 0);
+    }
+
+    for (i = 0; i < jobCount; ++i) {
+        if (jobs[i].openError || jobs[i].error != GFXValidatorErrorNone) {
+            ++failed;
+        }
+    }
+
+    return failed;
+}
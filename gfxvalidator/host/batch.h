@@ -0,0 +1,27 @@
+#ifndef _GFX_VALIDATOR_HOST_BATCH_H
+#define _GFX_VALIDATOR_HOST_BATCH_H
+
+#include "../validator.h"
+
+struct GFXBatchJob {
+    // RDRAM image the task was captured in
+    const char* snapshotPath;
+    // physical address of the OSTask in the snapshot
+    u32 taskAddress;
+    int maxGfxCount;
+    // the microcode the task was built for, 0 uses the one the library was
+    // built with
+    const struct GFXMicrocode* microcode;
+
+    // errno if the snapshot couldn't be opened, 0 otherwise
+    int openError;
+    enum GFXValidatorError error;
+    struct GFXValidationResult result;
+};
+
+// validates every job using up to threadCount worker threads, 0 uses one
+// thread per core. each job's result is written to the job so the output
+// order doesn't depend on scheduling. returns the number of failed jobs
+int gfxValidateBatch(struct GFXBatchJob* jobs, int jobCount, int threadCount);
+
+#endif
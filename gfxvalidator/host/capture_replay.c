@@ -0,0 +1,237 @@
+
+#include "capture_replay.h"
+#include "result_decoder.h"
+#include "../microcode.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void* gfxCaptureMemoryResolve(struct GFXMemory* memory, u32 address, u32 length) {
+    struct GFXCapture* capture = (struct GFXCapture*)memory;
+    u32 low = 0;
+    u32 high = capture->rangeCount;
+
+    // last range starting at or before address
+    while (low < high) {
+        u32 middle = (low + high) >> 1;
+
+        if (capture->ranges[middle].address <= address) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    if (low == 0) {
+        return 0;
+    }
+
+    struct GFXCaptureRange* range = &capture->ranges[low - 1];
+    u32 offset = address - range->address;
+
+    if (offset >= range->length || length > range->length - offset) {
+        return 0;
+    }
+
+    return range->data + offset;
+}
+
+struct GFXCaptureData {
+    const unsigned char* data;
+    u32 length;
+};
+
+// walks the records, counting data records, bytes and ranges. once
+// capture->ranges is allocated the second walk fills them in and collects
+// the data records repeats refer to
+int gfxCaptureParse(struct GFXCapture* capture, const unsigned char* input, u32 length, struct GFXCaptureData* dataRecords, u32* dataCount, u32* byteCount, u32* rangeCount) {
+    u32 offset = GFX_CAPTURE_HEADER_SIZE;
+    u32 previousEnd = 0;
+    struct GFXCaptureRange* range = 0;
+
+    *dataCount = 0;
+    *byteCount = 0;
+    *rangeCount = 0;
+
+    while (offset + GFX_CAPTURE_RECORD_SIZE <= length) {
+        const unsigned char* record = input + offset;
+        u32 address = gfxDecodeWord(record + 4);
+        u32 size = gfxDecodeWord(record + 8);
+        const unsigned char* data;
+
+        offset += GFX_CAPTURE_RECORD_SIZE;
+
+        if (record[0] == GFX_CAPTURE_END) {
+            return 0;
+        }
+
+        if (size == 0 || address < previousEnd || address + size < address || address + size > capture->memory.size) {
+            return -1;
+        }
+
+        if (record[0] == GFX_CAPTURE_DATA) {
+            if (size > length - offset) {
+                return -1;
+            }
+
+            data = input + offset;
+            offset += size;
+
+            if (capture->ranges) {
+                dataRecords[*dataCount].data = data;
+                dataRecords[*dataCount].length = size;
+            }
+
+            ++*dataCount;
+        } else if (record[0] == GFX_CAPTURE_REPEAT) {
+            if (4 > length - offset) {
+                return -1;
+            }
+
+            u32 index = gfxDecodeWord(input + offset);
+            offset += 4;
+
+            if (index >= *dataCount) {
+                return -1;
+            }
+
+            data = capture->ranges ? dataRecords[index].data : 0;
+
+            if (data && dataRecords[index].length != size) {
+                return -1;
+            }
+        } else {
+            return -1;
+        }
+
+        // chunks of the same run follow each other directly
+        if (!*rangeCount || address != previousEnd) {
+            if (capture->ranges) {
+                range = &capture->ranges[*rangeCount];
+                range->address = address;
+                range->length = 0;
+                range->data = capture->data + *byteCount;
+            }
+
+            ++*rangeCount;
+        }
+
+        if (capture->ranges) {
+            memcpy(range->data + range->length, data, size);
+            range->length += size;
+        }
+
+        *byteCount += size;
+        previousEnd = address + size;
+    }
+
+    // ran out before GFX_CAPTURE_END
+    return -1;
+}
+
+int gfxCaptureLoad(struct GFXCapture* capture, const unsigned char* input, u32 length) {
+    struct GFXCaptureData* dataRecords;
+    u32 dataCount;
+    u32 byteCount;
+    u32 rangeCount;
+    int i;
+
+    memset(capture, 0, sizeof(struct GFXCapture));
+
+    if (length < GFX_CAPTURE_HEADER_SIZE || input[0] != 'G' || input[1] != 'C' || input[2] != GFX_CAPTURE_VERSION || input[3] >= GFXMicrocodeCount) {
+        return -1;
+    }
+
+    capture->microcode = gfxMicrocodes[input[3]];
+    capture->memory.resolve = gfxCaptureMemoryResolve;
+    capture->memory.size = gfxDecodeWord(input + 4);
+    capture->listAddress = gfxDecodeWord(input + 8);
+
+    for (i = 0; i < GFX_MAX_SEGMENTS; ++i) {
+        capture->segments[i] = gfxDecodeWord(input + 12 + i * 4);
+    }
+
+    if (gfxCaptureParse(capture, input, length, 0, &dataCount, &byteCount, &rangeCount) != 0) {
+        return -1;
+    }
+
+    dataRecords = malloc(sizeof(struct GFXCaptureData) * (dataCount ? dataCount : 1));
+    capture->ranges = malloc(sizeof(struct GFXCaptureRange) * (rangeCount ? rangeCount : 1));
+    capture->data = malloc(byteCount ? byteCount : 1);
+
+    if (!dataRecords || !capture->ranges || !capture->data) {
+        free(dataRecords);
+        gfxCaptureClose(capture);
+        return -1;
+    }
+
+    if (gfxCaptureParse(capture, input, length, dataRecords, &dataCount, &byteCount, &capture->rangeCount) != 0) {
+        free(dataRecords);
+        gfxCaptureClose(capture);
+        return -1;
+    }
+
+    free(dataRecords);
+    return 0;
+}
+
+int gfxCaptureOpen(struct GFXCapture* capture, const char* path) {
+    FILE* file = fopen(path, "rb");
+    unsigned char* input;
+    long length;
+    int result;
+
+    if (!file) {
+        return -1;
+    }
+
+    if (fseek(file, 0, SEEK_END) != 0 || (length = ftell(file)) < 0 || fseek(file, 0, SEEK_SET) != 0) {
+        fclose(file);
+        return -1;
+    }
+
+    input = malloc(length ? length : 1);
+
+    if (!input) {
+        fclose(file);
+        errno = ENOMEM;
+        return -1;
+    }
+
+    if (fread(input, 1, length, file) != (size_t)length) {
+        free(input);
+        fclose(file);
+        errno = EIO;
+        return -1;
+    }
+
+    fclose(file);
+    result = gfxCaptureLoad(capture, input, (u32)length);
+    free(input);
+
+    if (result != 0) {
+        errno = EINVAL;
+    }
+
+    return result;
+}
+
+void gfxCaptureClose(struct GFXCapture* capture) {
+    free(capture->ranges);
+    free(capture->data);
+    capture->ranges = 0;
+    capture->rangeCount = 0;
+    capture->data = 0;
+}
+
+enum GFXValidatorError gfxReplayCapture(struct GFXCapture* capture, int maxGfxCount, struct GFXValidatorOptions* options, struct GFXValidationResult* result) {
+    struct GFXValidatorOptions replayOptions = *options;
+
+    replayOptions.memory = &capture->memory;
+    replayOptions.segments = capture->segments;
+    replayOptions.microcode = capture->microcode;
+
+    return gfxValidateDisplayList(capture->listAddress, maxGfxCount, &replayOptions, result);
+}
\ No newline at end of file
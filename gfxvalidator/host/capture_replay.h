@@ -0,0 +1,43 @@
+#ifndef _GFX_VALIDATOR_HOST_CAPTURE_REPLAY_H
+#define _GFX_VALIDATOR_HOST_CAPTURE_REPLAY_H
+
+#include "../capture.h"
+
+// a run of memory in a capture, runs never touch each other
+struct GFXCaptureRange {
+    u32 address;
+    u32 length;
+    unsigned char* data;
+};
+
+// a capture written by gfxCaptureDisplayList loaded back into memory the
+// validator can read from, anything that wasn't captured isn't backed
+struct GFXCapture {
+    struct GFXMemory memory;
+    u32 listAddress;
+    u32 segments[GFX_MAX_SEGMENTS];
+    // the microcode the display list was captured with
+    const struct GFXMicrocode* microcode;
+    // sorted by address
+    struct GFXCaptureRange* ranges;
+    u32 rangeCount;
+    // holds the data of every range
+    unsigned char* data;
+};
+
+void* gfxCaptureMemoryResolve(struct GFXMemory* memory, u32 address, u32 length);
+
+// returns 0 on success, -1 if input isn't a complete capture this version
+// understands. input isn't needed once it returns
+int gfxCaptureLoad(struct GFXCapture* capture, const unsigned char* input, u32 length);
+// returns 0 on success, -1 with errno set if the file couldn't be read or
+// EINVAL if it isn't a capture
+int gfxCaptureOpen(struct GFXCapture* capture, const char* path);
+void gfxCaptureClose(struct GFXCapture* capture);
+
+// validates the captured display list the same way it was validated when
+// it was captured. options.memory, options.segments and options.microcode
+// are replaced
+enum GFXValidatorError gfxReplayCapture(struct GFXCapture* capture, int maxGfxCount, struct GFXValidatorOptions* options, struct GFXValidationResult* result);
+
+#endif
\ No newline at end of file
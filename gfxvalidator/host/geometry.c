@@ -0,0 +1,295 @@
+
+#include "geometry.h"
+#include "../validator_internal.h"
+#include "../format.h"
+#include "../gfx_macros.h"
+#include <string.h>
+
+#define GEOMETRY_LINE_LENGTH    80
+
+// clip coordinates are s15.16 on the RSP
+#define GFX_CLIP_LIMIT          32768.0f
+
+void gfxTransformVertices(const float* matrix, const unsigned char* vertices, int count, int clipRatio, GFXFloat4* clip, GFXInt4* flags) {
+    int group;
+    int lane;
+    int i;
+
+    for (group = 0; group * GFX_VERTEX_LANES < count; ++group) {
+        GFXFloat4 position[3];
+
+        for (lane = 0; lane < GFX_VERTEX_LANES; ++lane) {
+            int index = group * GFX_VERTEX_LANES + lane;
+            // lanes past the end repeat the last vertex
+            const unsigned char* vertex = vertices + (index < count ? index : count - 1) * sizeof(Vtx);
+
+            for (i = 0; i < 3; ++i) {
+                position[i][lane] = (s16)((vertex[i * 2] << 8) | vertex[i * 2 + 1]);
+            }
+        }
+
+        GFXFloat4 x = position[0] * matrix[0] + position[1] * matrix[4] + position[2] * matrix[8] + matrix[12];
+        GFXFloat4 y = position[0] * matrix[1] + position[1] * matrix[5] + position[2] * matrix[9] + matrix[13];
+        GFXFloat4 z = position[0] * matrix[2] + position[1] * matrix[6] + position[2] * matrix[10] + matrix[14];
+        GFXFloat4 w = position[0] * matrix[3] + position[1] * matrix[7] + position[2] * matrix[11] + matrix[15];
+        GFXFloat4 band = w * (float)clipRatio;
+        // infinite or NaN when w is 0, either way subtracting it from itself
+        // doesn't give 0
+        GFXFloat4 screenX = x / w;
+        GFXFloat4 screenY = y / w;
+
+        GFXInt4 result =
+            ((x < -w) & GFX_CLIP_NEGATIVE_X) |
+            ((x > w) & GFX_CLIP_POSITIVE_X) |
+            ((y < -w) & GFX_CLIP_NEGATIVE_Y) |
+            ((y > w) & GFX_CLIP_POSITIVE_Y) |
+            ((z < -w) & GFX_CLIP_NEAR) |
+            ((z > w) & GFX_CLIP_FAR);
+
+        result |= ((screenX - screenX != 0.0f) | (screenY - screenY != 0.0f)) & GFX_VERTEX_NOT_FINITE;
+        result |= (
+            (x >= GFX_CLIP_LIMIT) | (x < -GFX_CLIP_LIMIT) |
+            (y >= GFX_CLIP_LIMIT) | (y < -GFX_CLIP_LIMIT) |
+            (z >= GFX_CLIP_LIMIT) | (z < -GFX_CLIP_LIMIT) |
+            (w >= GFX_CLIP_LIMIT) | (w < -GFX_CLIP_LIMIT)
+        ) & GFX_VERTEX_OVERFLOW;
+        // vertices behind the camera are always clipped
+        result |= (w > 0.0f) & ((x > band) | (x < -band) | (y > band) | (y < -band)) & GFX_VERTEX_GUARD_BAND;
+
+        clip[0 * GFX_VERTEX_GROUPS + group] = x;
+        clip[1 * GFX_VERTEX_GROUPS + group] = y;
+        clip[2 * GFX_VERTEX_GROUPS + group] = z;
+        clip[3 * GFX_VERTEX_GROUPS + group] = w;
+        flags[group] = result;
+    }
+}
+
+void gfxGeometryMoveWord(struct GFXValidatorState* state, struct GFXGeometryState* geometry, Gfx* command) {
+    int index;
+    int offset;
+    u32 data = GFX_W1(command);
+
+    state->microcode->moveWordTarget(command, &index, &offset);
+
+    switch (index) {
+        case G_MW_CLIP:
+            if (offset == G_MWO_CLIP_RNX && data > 0 && data < 256) {
+                geometry->clipRatio = data;
+            }
+            break;
+        // G_MW_FORCEMTX in F3DEX2, which only marks the matrix as forced
+        case 0x0c:
+            if (state->microcode->id == GFXMicrocodeF3D) {
+                // G_MW_POINTS changes a vertex after it was transformed
+                geometry->knownVertices = 0;
+            }
+            break;
+    }
+}
+
+void gfxGeometryVertices(struct GFXValidatorState* state, struct GFXGeometryReport* report, Gfx* command) {
+    struct GFXGeometryState* geometry = &report->geometry;
+    GFXFloat4 clip[4 * GFX_VERTEX_GROUPS];
+    GFXInt4 flags[GFX_VERTEX_GROUPS];
+    u32 problems[3] = {0, 0, 0};
+    u32 first[3] = {0, 0, 0};
+    const unsigned char* data;
+    int v0;
+    int count;
+    int i;
+    int j;
+
+    state->microcode->vertexRange(command, &v0, &count);
+
+    if (count <= 0 || v0 < 0 || v0 + count > state->microcode->vertexBufferSize) {
+        return;
+    }
+
+    u32 loaded = (count == 32 ? 0xFFFFFFFF : (1u << count) - 1) << v0;
+
+    report->vertices += count;
+    data = gfxReadSegmented(state, DMA_ADDR(command), count * sizeof(Vtx));
+
+    if (!data || !geometry->matrices.combinedKnown) {
+        geometry->knownVertices &= ~loaded;
+        report->untransformedVertices += count;
+        return;
+    }
+
+    if (gfxCheckPerspNorm(&geometry->matrices, state)) {
+        ++report->perspNormMismatches;
+    }
+
+    gfxTransformVertices(geometry->transform, data, count, geometry->clipRatio, clip, flags);
+
+    for (i = 0; i < count; ++i) {
+        int slot = v0 + i;
+        int group = i / GFX_VERTEX_LANES;
+        int lane = i % GFX_VERTEX_LANES;
+        int vertexFlags = flags[group][lane];
+
+        for (j = 0; j < 4; ++j) {
+            geometry->clip[slot][j] = clip[j * GFX_VERTEX_GROUPS + group][lane];
+        }
+
+        geometry->flags[slot] = vertexFlags;
+
+        for (j = 0; j < 3; ++j) {
+            if (vertexFlags & (GFX_VERTEX_NOT_FINITE << j)) {
+                first[j] = problems[j] ? first[j] : slot;
+                ++problems[j];
+            }
+        }
+    }
+
+    geometry->knownVertices |= loaded;
+
+    report->notFiniteVertices += problems[0];
+    report->overflowVertices += problems[1];
+    report->guardBandVertices += problems[2];
+
+    if (problems[0]) {
+        gfxWarn(state, GFXValidatorBadGeometry, GFXReasonVertexNotFinite, problems[0], first[0]);
+    }
+
+    if (problems[1]) {
+        gfxWarn(state, GFXValidatorBadGeometry, GFXReasonVertexOverflow, problems[1], first[1]);
+    }
+
+    if (problems[2]) {
+        gfxWarn(state, GFXValidatorBadGeometry, GFXReasonVertexGuardBand, problems[2], first[2]);
+    }
+}
+
+void gfxGeometryTriangles(struct GFXValidatorState* state, struct GFXGeometryReport* report, Gfx* command) {
+    struct GFXGeometryState* geometry = &report->geometry;
+    int vertices[6];
+    int count = state->microcode->triangles(command, vertices);
+    int i;
+
+    for (i = 0; i < count; ++i) {
+        int* triangle = &vertices[i * 3];
+
+        ++report->triangles;
+
+        if (triangle[0] >= state->microcode->vertexBufferSize ||
+            triangle[1] >= state->microcode->vertexBufferSize ||
+            triangle[2] >= state->microcode->vertexBufferSize) {
+            continue;
+        }
+
+        u32 used = (1u << triangle[0]) | (1u << triangle[1]) | (1u << triangle[2]);
+
+        if ((geometry->knownVertices & used) != used) {
+            ++report->untransformedTriangles;
+            continue;
+        }
+
+        float* a = geometry->clip[triangle[0]];
+        float* b = geometry->clip[triangle[1]];
+        float* c = geometry->clip[triangle[2]];
+        int flagsA = geometry->flags[triangle[0]];
+        int flagsB = geometry->flags[triangle[1]];
+        int flagsC = geometry->flags[triangle[2]];
+
+        if (flagsA & flagsB & flagsC & GFX_CLIP_ALL) {
+            ++report->offscreenTriangles;
+            gfxWarn(state, GFXValidatorBadGeometry, GFXReasonTriangleOffscreen, triangle[0], triangle[1], triangle[2]);
+            continue;
+        }
+
+        if ((flagsA | flagsB | flagsC) & GFX_VERTEX_NOT_FINITE) {
+            continue;
+        }
+
+        // twice the screen area scaled by the product of the w values, found
+        // without dividing so it works for vertices behind the camera
+        float area =
+            a[0] * (b[1] * c[3] - b[3] * c[1]) -
+            a[1] * (b[0] * c[3] - b[3] * c[0]) +
+            a[3] * (b[0] * c[1] - b[1] * c[0]);
+        float scale = a[3] * b[3] * c[3] * (GFX_DEGENERATE_AREA * 2.0f);
+
+        if ((area < 0.0f ? -area : area) <= (scale < 0.0f ? -scale : scale)) {
+            ++report->degenerateTriangles;
+            gfxWarn(state, GFXValidatorBadGeometry, GFXReasonTriangleDegenerate, triangle[0], triangle[1], triangle[2]);
+        }
+    }
+}
+
+void gfxGeometryMatrices(struct GFXValidatorState* state, struct GFXGeometryReport* report, Gfx* command) {
+    struct GFXGeometryState* geometry = &report->geometry;
+    int problems = gfxMatrixStackUpdate(&geometry->matrices, state, command);
+    int i;
+
+    report->overflowMatrices += (problems & GFX_MATRIX_OVERFLOWED) != 0;
+    report->singularMatrices += (problems & GFX_MATRIX_SINGULAR) != 0;
+
+    if (geometry->matrices.combinedKnown) {
+        for (i = 0; i < 16; ++i) {
+            geometry->transform[i] = geometry->matrices.combined[i] * (1.0f / 65536.0f);
+        }
+    }
+}
+
+void gfxGeometryVisitor(void* data, struct GFXValidatorState* state, Gfx* command) {
+    struct GFXGeometryReport* report = (struct GFXGeometryReport*)data;
+    struct GFXGeometryState* geometry = &report->geometry;
+
+    switch (GFX_COMMAND_KIND(state->microcode, command)) {
+        case GFXCommandMtx:
+        case GFXCommandPopMtx:
+        case GFXCommandMoveMem:
+            gfxGeometryMatrices(state, report, command);
+            break;
+        case GFXCommandMoveWord:
+            gfxGeometryMatrices(state, report, command);
+            gfxGeometryMoveWord(state, geometry, command);
+            break;
+        case GFXCommandModifyVertex:
+            geometry->knownVertices = 0;
+            break;
+        case GFXCommandVertex:
+            gfxGeometryVertices(state, report, command);
+            break;
+        case GFXCommandTri1:
+        case GFXCommandTri2:
+        case GFXCommandQuad:
+            gfxGeometryTriangles(state, report, command);
+            break;
+    }
+}
+
+void gfxGeometryReportInit(struct GFXGeometryReport* report) {
+    memset(report, 0, sizeof(struct GFXGeometryReport));
+}
+
+enum GFXValidatorError gfxCheckGeometry(u32 address, int maxGfxCount, struct GFXValidatorOptions* options, struct GFXGeometryReport* report, struct GFXValidationResult* result) {
+    struct GFXValidatorOptions geometryOptions = *options;
+
+    memset(&report->geometry, 0, sizeof(report->geometry));
+    gfxMatrixStackInit(&report->geometry.matrices);
+    report->geometry.clipRatio = GFX_DEFAULT_CLIP_RATIO;
+
+    // every command has to be seen so nothing can be skipped by the cache
+    geometryOptions.cache = 0;
+    geometryOptions.visitor = gfxGeometryVisitor;
+    geometryOptions.visitorData = report;
+
+    return gfxValidateDisplayList(address, maxGfxCount, &geometryOptions, result);
+}
+
+void gfxPrintGeometryReport(struct GFXGeometryReport* report, gfxPrinter printer) {
+    char line[GEOMETRY_LINE_LENGTH];
+
+    printer(line, gfxFormat(line, GEOMETRY_LINE_LENGTH, "%u matrix products overflowed\n", report->overflowMatrices));
+    printer(line, gfxFormat(line, GEOMETRY_LINE_LENGTH, "%u singular modelview matrices\n", report->singularMatrices));
+    printer(line, gfxFormat(line, GEOMETRY_LINE_LENGTH, "%u perspective normalizations that don't match\n", report->perspNormMismatches));
+    printer(line, gfxFormat(line, GEOMETRY_LINE_LENGTH, "%u vertices, %u not transformed\n", report->vertices, report->untransformedVertices));
+    printer(line, gfxFormat(line, GEOMETRY_LINE_LENGTH, "  %u with no screen position\n", report->notFiniteVertices));
+    printer(line, gfxFormat(line, GEOMETRY_LINE_LENGTH, "  %u overflow clip coordinates\n", report->overflowVertices));
+    printer(line, gfxFormat(line, GEOMETRY_LINE_LENGTH, "  %u outside the guard band\n", report->guardBandVertices));
+    printer(line, gfxFormat(line, GEOMETRY_LINE_LENGTH, "%u triangles, %u not transformed\n", report->triangles, report->untransformedTriangles));
+    printer(line, gfxFormat(line, GEOMETRY_LINE_LENGTH, "  %u with no area\n", report->degenerateTriangles));
+    printer(line, gfxFormat(line, GEOMETRY_LINE_LENGTH, "  %u entirely off screen\n", report->offscreenTriangles));
+}
\ No newline at end of file
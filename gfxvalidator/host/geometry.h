@@ -0,0 +1,91 @@
+#ifndef _GFX_VALIDATOR_HOST_GEOMETRY_H
+#define _GFX_VALIDATOR_HOST_GEOMETRY_H
+
+#include "../validator.h"
+#include "matrix_stack.h"
+
+// largest vertex buffer of any microcode
+#define GFX_MAX_VERTEX_BUFFER   32
+
+// vertices are transformed this many at a time
+#define GFX_VERTEX_LANES        4
+#define GFX_VERTEX_GROUPS       (GFX_MAX_VERTEX_BUFFER / GFX_VERTEX_LANES)
+
+typedef float GFXFloat4 __attribute__((vector_size(GFX_VERTEX_LANES * sizeof(float))));
+typedef s32 GFXInt4 __attribute__((vector_size(GFX_VERTEX_LANES * sizeof(s32))));
+
+// clip codes, a triangle is off screen when its vertices share one
+#define GFX_CLIP_NEGATIVE_X     (1 << 0)
+#define GFX_CLIP_POSITIVE_X     (1 << 1)
+#define GFX_CLIP_NEGATIVE_Y     (1 << 2)
+#define GFX_CLIP_POSITIVE_Y     (1 << 3)
+#define GFX_CLIP_NEAR           (1 << 4)
+#define GFX_CLIP_FAR            (1 << 5)
+#define GFX_CLIP_ALL            0x3F
+// problems with a vertex
+#define GFX_VERTEX_NOT_FINITE   (1 << 6)
+#define GFX_VERTEX_OVERFLOW     (1 << 7)
+#define GFX_VERTEX_GUARD_BAND   (1 << 8)
+
+// the RSP clips against a frustum this many times wider than the screen
+// until G_MW_CLIP changes it
+#define GFX_DEFAULT_CLIP_RATIO  2
+
+// a triangle covering less than this much of the screen in normalized
+// device coordinates, about a fiftieth of a pixel at 320x240, has no area
+#define GFX_DEGENERATE_AREA     1e-6f
+
+// what the RSP holds while transforming vertices
+struct GFXGeometryState {
+    struct GFXMatrixStack matrices;
+    // matrices.combined as floats, row major multiplying row vectors
+    float transform[16];
+    u8 clipRatio;
+    // transformed vertex buffer
+    float clip[GFX_MAX_VERTEX_BUFFER][4];
+    u16 flags[GFX_MAX_VERTEX_BUFFER];
+    // bit per slot transformed with known matrices
+    u32 knownVertices;
+};
+
+struct GFXGeometryReport {
+    // totals over every call
+    u32 vertices;
+    u32 triangles;
+    // loaded or drawn before the matrices were known
+    u32 untransformedVertices;
+    u32 untransformedTriangles;
+    u32 notFiniteVertices;
+    u32 overflowVertices;
+    u32 guardBandVertices;
+    u32 degenerateTriangles;
+    u32 offscreenTriangles;
+    // G_MTX, G_POPMTX, G_MOVEMEM and G_MOVEWORD commands that left the
+    // matrices with a problem
+    u32 overflowMatrices;
+    u32 singularMatrices;
+    u32 perspNormMismatches;
+    struct GFXGeometryState geometry;
+};
+
+// transforms count big endian Vtx by matrix into clip coordinates and sets
+// GFX_CLIP_* and GFX_VERTEX_* flags for each. clip and flags are indexed by
+// GFX_VERTEX_GROUPS * component + vertex / GFX_VERTEX_LANES
+void gfxTransformVertices(const float* matrix, const unsigned char* vertices, int count, int clipRatio, GFXFloat4* clip, GFXInt4* flags);
+
+void gfxGeometryReportInit(struct GFXGeometryReport* report);
+
+// validates the display list at address while transforming every vertex it
+// loads with the matrices it loads. matrix products that overflow,
+// singular modelview matrices, a G_MW_PERSPNORM that doesn't match the
+// projection, vertices with no screen position, clip coordinates that
+// overflow or that need clipping and triangles with no area or that are
+// entirely off screen are reported as
+// GFXValidatorBadGeometry warnings to options.onWarning and
+// options.diagnostics and counted in report. options.visitor and
+// options.cache are ignored
+enum GFXValidatorError gfxCheckGeometry(u32 address, int maxGfxCount, struct GFXValidatorOptions* options, struct GFXGeometryReport* report, struct GFXValidationResult* result);
+
+void gfxPrintGeometryReport(struct GFXGeometryReport* report, gfxPrinter printer);
+
+#endif
\ No newline at end of file
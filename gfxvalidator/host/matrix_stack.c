@@ -0,0 +1,266 @@
+
+#include "matrix_stack.h"
+#include "../validator_internal.h"
+#include "../gfx_macros.h"
+#include <string.h>
+
+void gfxMatrixStackInit(struct GFXMatrixStack* stack) {
+    memset(stack, 0, sizeof(struct GFXMatrixStack));
+}
+
+const unsigned char* gfxReadSegmented(struct GFXValidatorState* state, u32 address, u32 length) {
+    int segment = _SHIFTR(address, 24, 4);
+
+    if (state->pipeline.segments[segment] == SEGMENT_UNINITIALIZED) {
+        return 0;
+    }
+
+    return gfxMemoryResolve(state->memory, (state->pipeline.segments[segment] + (address & 0xFFFFFF)) & 0xFFFFFFF, length);
+}
+
+void gfxDecodeFixedMatrix(const unsigned char* data, s32* output) {
+    int i;
+
+    // the integer halves of every element come first then the fractions
+    for (i = 0; i < 16; ++i) {
+        output[i] = (s32)(((u32)data[i * 2] << 24) | ((u32)data[i * 2 + 1] << 16) | ((u32)data[32 + i * 2] << 8) | data[33 + i * 2]);
+    }
+}
+
+int gfxMultiplyFixedMatrix(const s32* a, const s32* b, s32* output) {
+    s32 result[16];
+    int overflow = -1;
+    int row;
+    int column;
+    int i;
+
+    for (row = 0; row < 4; ++row) {
+        for (column = 0; column < 4; ++column) {
+            s64 sum = 0;
+
+            for (i = 0; i < 4; ++i) {
+                sum += ((s64)a[row * 4 + i] * b[i * 4 + column]) >> 16;
+            }
+
+            if (overflow == -1 && (sum > 0x7FFFFFFF || sum < -0x7FFFFFFF - 1)) {
+                overflow = row * 4 + column;
+            }
+
+            result[row * 4 + column] = (s32)sum;
+        }
+    }
+
+    memcpy(output, result, sizeof(result));
+    return overflow;
+}
+
+// sets half of an element the way the RSP does for G_MW_MATRIX and
+// G_MV_MATRIX, offset is into the Mtx layout
+void gfxSetMatrixHalf(s32* matrix, int offset, u16 value) {
+    int element = (offset & 0x1F) >> 1;
+
+    if (offset & 0x20) {
+        matrix[element] = (s32)(((u32)matrix[element] & 0xFFFF0000) | value);
+    } else {
+        matrix[element] = (s32)(((u32)value << 16) | ((u32)matrix[element] & 0xFFFF));
+    }
+}
+
+int gfxReportOverflow(struct GFXValidatorState* state, int element) {
+    if (element < 0) {
+        return 0;
+    }
+
+    gfxWarn(state, GFXValidatorBadGeometry, GFXReasonMatrixOverflow, element / 4, element % 4);
+    return GFX_MATRIX_OVERFLOWED;
+}
+
+// rows of the upper 3x3 that are nearly parallel or too short to be precise
+int gfxCheckSingular(struct GFXMatrixStack* stack, struct GFXValidatorState* state) {
+    const s32* m = stack->modelview[stack->depth];
+    double rows[3][3];
+    double lengths[3];
+    int i;
+    int j;
+
+    for (i = 0; i < 3; ++i) {
+        lengths[i] = 0.0;
+
+        for (j = 0; j < 3; ++j) {
+            rows[i][j] = m[i * 4 + j] / 65536.0;
+            lengths[i] += rows[i][j] * rows[i][j];
+        }
+    }
+
+    double determinant =
+        rows[0][0] * (rows[1][1] * rows[2][2] - rows[1][2] * rows[2][1]) -
+        rows[0][1] * (rows[1][0] * rows[2][2] - rows[1][2] * rows[2][0]) +
+        rows[0][2] * (rows[1][0] * rows[2][1] - rows[1][1] * rows[2][0]);
+    double squaredVolume = lengths[0] * lengths[1] * lengths[2];
+    double minScale = GFX_MIN_MATRIX_SCALE * GFX_MIN_MATRIX_SCALE;
+
+    if (lengths[0] >= minScale && lengths[1] >= minScale && lengths[2] >= minScale &&
+        determinant * determinant >= GFX_SINGULAR_RATIO * GFX_SINGULAR_RATIO * squaredVolume) {
+        return 0;
+    }
+
+    gfxWarn(state, GFXValidatorBadGeometry, GFXReasonMatrixSingular, stack->depth);
+    return GFX_MATRIX_SINGULAR;
+}
+
+// the RSP combines the matrices whenever one of them changes
+int gfxCombineMatrices(struct GFXMatrixStack* stack, struct GFXValidatorState* state) {
+    stack->combinedKnown = stack->projectionKnown && (stack->modelviewKnown & (1 << stack->depth));
+    stack->forcedQuarters = 0;
+
+    if (!stack->combinedKnown) {
+        return 0;
+    }
+
+    return gfxReportOverflow(state, gfxMultiplyFixedMatrix(stack->modelview[stack->depth], stack->projection, stack->combined));
+}
+
+int gfxMatrixStackLoad(struct GFXMatrixStack* stack, struct GFXValidatorState* state, Gfx* command) {
+    int flags = state->microcode->matrixFlags(command);
+    const unsigned char* data = gfxReadSegmented(state, DMA_ADDR(command), sizeof(Mtx));
+    int problems = 0;
+    s32 matrix[16];
+    s32* target;
+    int known;
+
+    if (data) {
+        gfxDecodeFixedMatrix(data, matrix);
+    }
+
+    if (flags & GFX_MATRIX_PROJECTION) {
+        target = stack->projection;
+        known = stack->projectionKnown;
+        stack->perspNormChecked = 0;
+    } else {
+        if ((flags & GFX_MATRIX_PUSH) && stack->depth < GFX_MAX_MATRIX_STACK) {
+            memcpy(stack->modelview[stack->depth + 1], stack->modelview[stack->depth], sizeof(stack->modelview[0]));
+            stack->modelviewKnown = (stack->modelviewKnown & ~(2 << stack->depth)) | ((stack->modelviewKnown & (1 << stack->depth)) << 1);
+            ++stack->depth;
+        }
+
+        target = stack->modelview[stack->depth];
+        known = (stack->modelviewKnown >> stack->depth) & 1;
+    }
+
+    if (!data) {
+        known = 0;
+    } else if (flags & GFX_MATRIX_LOAD) {
+        memcpy(target, matrix, sizeof(matrix));
+        known = 1;
+    } else if (known) {
+        problems |= gfxReportOverflow(state, gfxMultiplyFixedMatrix(matrix, target, target));
+    }
+
+    if (flags & GFX_MATRIX_PROJECTION) {
+        stack->projectionKnown = known;
+    } else if (known) {
+        stack->modelviewKnown |= 1 << stack->depth;
+        problems |= gfxCheckSingular(stack, state);
+    } else {
+        stack->modelviewKnown &= ~(1 << stack->depth);
+    }
+
+    return problems | gfxCombineMatrices(stack, state);
+}
+
+// G_MV_MATRIX replaces part of the combined matrix until the next G_MTX or
+// G_POPMTX
+void gfxMatrixStackForce(struct GFXMatrixStack* stack, struct GFXValidatorState* state, Gfx* command, int offset, int length) {
+    const unsigned char* data = gfxReadSegmented(state, DMA_ADDR(command), length);
+    int i;
+
+    if (!data || offset < 0 || offset + length > (int)sizeof(Mtx)) {
+        stack->combinedKnown = 0;
+        stack->forcedQuarters = 0;
+        return;
+    }
+
+    for (i = 0; i + 1 < length; i += 2) {
+        gfxSetMatrixHalf(stack->combined, offset + i, (data[i] << 8) | data[i + 1]);
+    }
+
+    for (i = offset >> 4; i < (offset + length + 15) >> 4; ++i) {
+        stack->forcedQuarters |= 1 << i;
+    }
+
+    stack->combinedKnown |= stack->forcedQuarters == 0xF;
+}
+
+int gfxMatrixStackUpdate(struct GFXMatrixStack* stack, struct GFXValidatorState* state, Gfx* command) {
+    int index;
+    int offset;
+    int length;
+
+    switch (GFX_COMMAND_KIND(state->microcode, command)) {
+        case GFXCommandMtx:
+            return gfxMatrixStackLoad(stack, state, command);
+        case GFXCommandPopMtx:
+            length = state->microcode->popCount(command);
+            stack->depth = length < stack->depth ? stack->depth - length : 0;
+            return gfxCombineMatrices(stack, state);
+        case GFXCommandMoveMem:
+            if (state->microcode->matrixMove(command, &offset, &length)) {
+                gfxMatrixStackForce(stack, state, command, offset, length);
+            }
+            break;
+        case GFXCommandMoveWord:
+            state->microcode->moveWordTarget(command, &index, &offset);
+
+            if (index == G_MW_MATRIX && offset >= 0 && offset < (int)sizeof(Mtx)) {
+                // gSPInsertMatrix, two halves of the combined matrix a word
+                gfxSetMatrixHalf(stack->combined, offset, GFX_W1(command) >> 16);
+                gfxSetMatrixHalf(stack->combined, offset + 2, GFX_W1(command) & 0xFFFF);
+            } else if (index == G_MW_PERSPNORM) {
+                stack->perspNorm = GFX_W1(command) & 0xFFFF;
+                stack->perspNormChecked = 0;
+            }
+            break;
+    }
+
+    return 0;
+}
+
+int gfxCheckPerspNorm(struct GFXMatrixStack* stack, struct GFXValidatorState* state) {
+    const s32* m = stack->projection;
+
+    if (stack->perspNormChecked || !stack->perspNorm || !stack->projectionKnown) {
+        return 0;
+    }
+
+    stack->perspNormChecked = 1;
+
+    // only guPerspective puts -scale in m[2][3] and 0 in m[3][3], the
+    // scale is divided back out to find the near and far planes
+    if (m[11] >= 0 || m[15] != 0) {
+        return 0;
+    }
+
+    double a = (double)m[10] / -m[11];
+    double b = (double)m[14] / -m[11];
+
+    if (a == 1.0 || a == -1.0) {
+        return 0;
+    }
+
+    double nearPlane = b / (a - 1.0);
+    double farPlane = b / (a + 1.0);
+    double expected = nearPlane + farPlane <= 2.0 ? 65535.0 : 2.0 * 65536.0 / (nearPlane + farPlane);
+
+    if (expected < 1.0) {
+        expected = 1.0;
+    }
+
+    double difference = stack->perspNorm - expected;
+
+    if ((difference < 0 ? -difference : difference) <= expected * GFX_PERSPNORM_TOLERANCE + 1.0) {
+        return 0;
+    }
+
+    gfxWarn(state, GFXValidatorBadGeometry, GFXReasonPerspNormMismatch, stack->perspNorm, (u32)expected);
+    return GFX_MATRIX_PERSPNORM_MISMATCH;
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef _GFX_VALIDATOR_HOST_MATRIX_STACK_H
+#define _GFX_VALIDATOR_HOST_MATRIX_STACK_H
+
+#include "../validator.h"
+
+// problems found by gfxMatrixStackUpdate and gfxCheckPerspNorm
+#define GFX_MATRIX_OVERFLOWED           (1 << 0)
+#define GFX_MATRIX_SINGULAR             (1 << 1)
+#define GFX_MATRIX_PERSPNORM_MISMATCH   (1 << 2)
+
+// a modelview matrix whose rows are this far from independent, measured as
+// the determinant over the product of the row lengths, is nearly singular
+#define GFX_SINGULAR_RATIO      1e-3
+// rows shorter than this keep fewer than 8 bits of s15.16 precision
+#define GFX_MIN_MATRIX_SCALE    (1.0 / 256.0)
+// G_MW_PERSPNORM can be this far from the value guPerspective gives
+#define GFX_PERSPNORM_TOLERANCE 0.02
+
+// the matrices the RSP holds, kept in s15.16 and multiplied the way the RSP
+// does so overflow wraps the same way. matrices are row major and multiply
+// row vectors
+struct GFXMatrixStack {
+    // modelview[depth] is the current modelview matrix
+    s32 modelview[GFX_MAX_MATRIX_STACK + 1][16];
+    s32 projection[16];
+    // modelview times projection unless it was forced, vertices are
+    // transformed by this
+    s32 combined[16];
+    int depth;
+    // bit per modelview entry, 0 until the display list loads one
+    u16 modelviewKnown;
+    u8 projectionKnown;
+    u8 combinedKnown;
+    // bit per 16 bytes of combined written by G_MOVEMEM since it was last
+    // computed
+    u8 forcedQuarters;
+    u8 perspNormChecked;
+    // set by G_MW_PERSPNORM, 0 until then
+    u16 perspNorm;
+};
+
+void gfxMatrixStackInit(struct GFXMatrixStack* stack);
+
+// the data at a segmented address in state if the segment is set
+const unsigned char* gfxReadSegmented(struct GFXValidatorState* state, u32 address, u32 length);
+
+// Mtx as stored in RDRAM to row major s15.16
+void gfxDecodeFixedMatrix(const unsigned char* data, s32* output);
+// output = a * b, output can be either input. returns the index of the
+// first element that overflowed s15.16 or -1
+int gfxMultiplyFixedMatrix(const s32* a, const s32* b, s32* output);
+
+// updates the stack for the G_MTX, G_POPMTX, G_MOVEMEM or G_MOVEWORD about
+// to run in state. each problem found is reported as a
+// GFXValidatorBadGeometry warning and the GFX_MATRIX_* bits for them are
+// returned
+int gfxMatrixStackUpdate(struct GFXMatrixStack* stack, struct GFXValidatorState* state, Gfx* command);
+// checks G_MW_PERSPNORM against the perspective projection once each time
+// either changes, call before vertices are transformed
+int gfxCheckPerspNorm(struct GFXMatrixStack* stack, struct GFXValidatorState* state);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,211 @@
+
+#include "optimizer.h"
+#include "../redundancy.h"
+#include "../validator_internal.h"
+#include "../gfx_macros.h"
+
+#include <string.h>
+
+struct GFXOptimizer {
+    const struct GFXMicrocode* microcode;
+    struct GFXOptimizedList* output;
+    struct GFXOptimizeStats* stats;
+    struct GFXShadowState shadow;
+    u32 address;
+    // the list branched away or ended
+    char done;
+    char overflowed;
+    // the last command written can still be combined with the next one
+    char lastWasCall;
+    char lastWasTri1;
+    // the command of a flattened call is written once it is visited so it
+    // can still be dropped as redundant
+    char inlinePending;
+};
+
+void gfxOptimizerEmit(struct GFXOptimizer* optimizer, Gfx* command) {
+    struct GFXOptimizedList* output = optimizer->output;
+    int kind = GFX_COMMAND_KIND(optimizer->microcode, command);
+
+    if (kind == GFXCommandTri1 && optimizer->lastWasTri1 && optimizer->microcode->mergeTriangles) {
+        Gfx* previous = &output->commands[output->length - 1];
+        optimizer->microcode->mergeTriangles(previous, command, previous);
+        optimizer->lastWasTri1 = 0;
+        ++optimizer->stats->trianglesMerged;
+        return;
+    }
+
+    if (output->length == output->capacity) {
+        optimizer->overflowed = 1;
+        optimizer->done = 1;
+        return;
+    }
+
+    output->commands[output->length++] = *command;
+    optimizer->lastWasCall = kind == GFXCommandDL && DMA1_PARAM(command) == G_DL_PUSH;
+    optimizer->lastWasTri1 = kind == GFXCommandTri1;
+}
+
+// tries to replace a call to a display list holding at most one command,
+// returns 1 if the call was handled
+int gfxOptimizerFlattenCall(struct GFXOptimizer* optimizer, struct GFXValidatorState* state, Gfx* command) {
+    int address;
+
+    if (gfxTranslateAddress(state, DMA_ADDR(command), &address) != GFXValidatorErrorNone) {
+        // the validator reports it once it reaches the command
+        state->reasonId = GFXReasonNone;
+        return 0;
+    }
+
+    Gfx* target = gfxMemoryResolve(state->memory, address, sizeof(Gfx) * 2);
+
+    if (!target) {
+        return 0;
+    }
+
+    if (GFX_COMMAND_KIND(state->microcode, &target[0]) == GFXCommandEndDL) {
+        ++optimizer->stats->listsFlattened;
+        return 1;
+    }
+
+    switch (GFX_COMMAND_KIND(state->microcode, &target[0])) {
+        case GFXCommandUnknown:
+        case GFXCommandDL:
+        case GFXCommandCullDL:
+        case GFXCommandRDPHalf1:
+        case GFXCommandRDPHalf2:
+        case GFXCommandRDPHalfCont:
+        case GFXCommandBranchZ:
+        case GFXCommandLoadUcode:
+        case GFXCommandDmaIO:
+        case GFXCommandSpecial:
+            // these depend on what is around them in the list or can end or
+            // branch it, a G_CULLDL copied into the caller would end the
+            // caller instead
+            return 0;
+    }
+
+    switch (GFX_COMMAND(&target[0])) {
+        case (u8)G_TEXRECT:
+        case (u8)G_TEXRECTFLIP:
+            return 0;
+    }
+
+    if (GFX_COMMAND_KIND(state->microcode, &target[1]) != GFXCommandEndDL) {
+        return 0;
+    }
+
+    optimizer->inlinePending = 1;
+    ++optimizer->stats->listsFlattened;
+    return 1;
+}
+
+void gfxOptimizerVisit(void* data, struct GFXValidatorState* state, Gfx* command) {
+    struct GFXOptimizer* optimizer = (struct GFXOptimizer*)data;
+    int redundant = gfxShadowUpdate(state, &optimizer->shadow, command);
+
+    if (optimizer->done) {
+        return;
+    }
+
+    if (optimizer->inlinePending) {
+        optimizer->inlinePending = 0;
+
+        if (redundant) {
+            ++optimizer->stats->redundantRemoved;
+        } else {
+            gfxOptimizerEmit(optimizer, command);
+        }
+
+        return;
+    }
+
+    if (state->gfxStackSize != 1 || state->gfxStack[0].startAddress != optimizer->address) {
+        // a branch already ended the copy, anything else at the top level is
+        // the list that was branched to
+        optimizer->done = state->gfxStackSize == 1;
+        return;
+    }
+
+    ++optimizer->stats->inputCommands;
+
+    switch (GFX_COMMAND_KIND(state->microcode, command)) {
+        case GFXCommandSPNoop:
+            ++optimizer->stats->noopsRemoved;
+            return;
+        case GFXCommandEndDL:
+            optimizer->done = 1;
+
+            // a call right before the end can be a branch instead
+            if (optimizer->lastWasCall) {
+                Gfx* call = &optimizer->output->commands[optimizer->output->length - 1];
+                call->words.w0 = GFX_WORD((GFX_W0(call) & 0xFF000000) | _SHIFTL(G_DL_NOPUSH, 16, 8));
+                ++optimizer->stats->listsFlattened;
+                return;
+            }
+            break;
+        case GFXCommandDL:
+            if (DMA1_PARAM(command) == G_DL_NOPUSH) {
+                optimizer->done = 1;
+            } else if (gfxOptimizerFlattenCall(optimizer, state, command)) {
+                return;
+            }
+            break;
+        default:
+            if (redundant) {
+                ++optimizer->stats->redundantRemoved;
+                return;
+            }
+            break;
+    }
+
+    gfxOptimizerEmit(optimizer, command);
+}
+
+enum GFXValidatorError gfxOptimizeDisplayList(u32 address, u32 outputAddress, int maxGfxCount, struct GFXValidatorOptions* options, struct GFXOptimizedList* output, struct GFXOptimizeStats* stats, struct GFXValidationResult* result) {
+    struct GFXValidatorOptions optimizeOptions = *options;
+    struct GFXOptimizer optimizer;
+    struct GFXOverlayMemory overlay;
+    enum GFXValidatorError error;
+
+    memset(&optimizer, 0, sizeof(optimizer));
+    memset(stats, 0, sizeof(struct GFXOptimizeStats));
+    optimizer.microcode = options->microcode ? options->microcode : gfxDefaultMicrocode();
+    optimizer.output = output;
+    optimizer.stats = stats;
+    optimizer.address = address;
+    output->length = 0;
+
+    // every command has to be seen and only a list without errors is
+    // rewritten
+    optimizeOptions.cache = 0;
+    optimizeOptions.diagnostics = 0;
+    optimizeOptions.onWarning = 0;
+    optimizeOptions.visitor = gfxOptimizerVisit;
+    optimizeOptions.visitorData = &optimizer;
+
+    error = gfxValidateDisplayList(address, maxGfxCount, &optimizeOptions, result);
+
+    if (error != GFXValidatorErrorNone) {
+        return error;
+    }
+
+    if (optimizer.overflowed) {
+        result->gfxStackSize = 0;
+        result->reason = GFXValidatorInvalidArguments;
+        result->reasonId = GFXReasonOptimizeOutputFull;
+        result->reasonArgs[0] = output->capacity;
+        result->reasonArgs[1] = 0;
+        result->reasonArgs[2] = 0;
+        return GFXValidatorInvalidArguments;
+    }
+
+    stats->outputCommands = output->length;
+
+    gfxOverlayMemoryInit(&overlay, options->memory, outputAddress, output->commands, output->length * sizeof(Gfx));
+    optimizeOptions = *options;
+    optimizeOptions.memory = &overlay.memory;
+    optimizeOptions.cache = 0;
+
+    return gfxValidateDisplayList(outputAddress, maxGfxCount, &optimizeOptions, result);
+}
\ No newline at end of file
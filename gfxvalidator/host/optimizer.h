@@ -0,0 +1,35 @@
+#ifndef _GFX_VALIDATOR_HOST_OPTIMIZER_H
+#define _GFX_VALIDATOR_HOST_OPTIMIZER_H
+
+#include "../validator.h"
+
+struct GFXOptimizedList {
+    // written in the same byte order as RDRAM
+    Gfx* commands;
+    u32 capacity;
+    u32 length;
+};
+
+struct GFXOptimizeStats {
+    // commands in the list up to its G_ENDDL or branch
+    u32 inputCommands;
+    u32 outputCommands;
+    u32 noopsRemoved;
+    u32 redundantRemoved;
+    // G_TRI1 pairs merged into a G_TRI2
+    u32 trianglesMerged;
+    // calls to empty or single command display lists and calls turned into
+    // branches
+    u32 listsFlattened;
+};
+
+// writes a copy of the display list at address to output with commands
+// that don't change the state and G_SPNOOP removed, G_TRI1 pairs merged
+// into G_TRI2 and trivial display list calls flattened. only the list at
+// address is rewritten, the display lists it calls are left as they are.
+// the copy is validated again as if it replaced the list at outputAddress,
+// result holds the error if either validation fails or
+// GFXReasonOptimizeOutputFull if output is too small
+enum GFXValidatorError gfxOptimizeDisplayList(u32 address, u32 outputAddress, int maxGfxCount, struct GFXValidatorOptions* options, struct GFXOptimizedList* output, struct GFXOptimizeStats* stats, struct GFXValidationResult* result);
+
+#endif
\ No newline at end of file
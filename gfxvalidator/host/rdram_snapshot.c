@@ -0,0 +1,55 @@
+
+#include "rdram_snapshot.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define RDRAM_MAX_SIZE  (8 * 1024 * 1024)
+
+int gfxSnapshotOpen(struct GFXRDRAMSnapshot* snapshot, const char* path) {
+    struct stat fileStat;
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0) {
+        return -1;
+    }
+
+    if (fstat(fd, &fileStat) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    if (fileStat.st_size <= 0 || fileStat.st_size > RDRAM_MAX_SIZE) {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+
+    void* mapping = mmap(0, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping keeps its own reference to the file
+    close(fd);
+
+    if (mapping == MAP_FAILED) {
+        return -1;
+    }
+
+    snapshot->mapping = mapping;
+    snapshot->mappingSize = fileStat.st_size;
+    gfxLinearMemoryInit(&snapshot->memory, mapping, (u32)fileStat.st_size);
+
+    return 0;
+}
+
+void gfxSnapshotClose(struct GFXRDRAMSnapshot* snapshot) {
+    if (snapshot->mapping) {
+        munmap(snapshot->mapping, snapshot->mappingSize);
+    }
+
+    snapshot->mapping = 0;
+    snapshot->mappingSize = 0;
+    snapshot->memory.data = 0;
+    snapshot->memory.size = 0;
+}
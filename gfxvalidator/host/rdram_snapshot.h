@@ -0,0 +1,18 @@
+#ifndef _GFX_VALIDATOR_HOST_RDRAM_SNAPSHOT_H
+#define _GFX_VALIDATOR_HOST_RDRAM_SNAPSHOT_H
+
+#include "../memory.h"
+
+// a raw 4 or 8 MB RDRAM image mapped read only into the host address space
+// the image is expected in the same byte order as the console
+struct GFXRDRAMSnapshot {
+    struct GFXMemory memory;
+    void* mapping;
+    unsigned long mappingSize;
+};
+
+// returns 0 on success, -1 with errno set on failure
+int gfxSnapshotOpen(struct GFXRDRAMSnapshot* snapshot, const char* path);
+void gfxSnapshotClose(struct GFXRDRAMSnapshot* snapshot);
+
+#endif
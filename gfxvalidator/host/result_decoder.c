@@ -0,0 +1,52 @@
+
+#include "result_decoder.h"
+#include "../microcode.h"
+#include "../gfx_macros.h"
+
+u32 gfxDecodeWord(const unsigned char* input) {
+    return ((u32)input[0] << 24) | ((u32)input[1] << 16) | ((u32)input[2] << 8) | (u32)input[3];
+}
+
+int gfxDecodeResult(const unsigned char* input, unsigned length, struct GFXValidationResult* result) {
+    const unsigned char* curr = input;
+    int i;
+
+    if (length < GFX_ENCODED_HEADER_SIZE) {
+        return 0;
+    }
+
+    int stackSize = input[6];
+    int argCount = input[7];
+
+    if (input[0] != 'G' || input[1] != 'V' || input[2] != GFX_ENCODING_VERSION || 
+        stackSize > GFX_MAX_GFX_STACK || argCount != GFX_MAX_REASON_ARGS || input[8] >= GFXMicrocodeCount) {
+        return -1;
+    }
+
+    unsigned size = GFX_ENCODED_HEADER_SIZE + argCount * 4 + stackSize * GFX_ENCODED_STACK_ENTRY;
+
+    if (length < size) {
+        return 0;
+    }
+
+    result->reason = input[3];
+    result->reasonId = (input[4] << 8) | input[5];
+    result->gfxStackSize = stackSize;
+    result->microcode = input[8];
+    curr += GFX_ENCODED_HEADER_SIZE;
+
+    for (i = 0; i < argCount; ++i) {
+        result->reasonArgs[i] = gfxDecodeWord(curr);
+        curr += 4;
+    }
+
+    for (i = 0; i < stackSize; ++i) {
+        result->gfxStackAddress[i] = gfxDecodeWord(curr);
+        // stored the way they were in RDRAM so the printer can read them
+        result->gfxStack[i].words.w0 = GFX_WORD(gfxDecodeWord(curr + 4));
+        result->gfxStack[i].words.w1 = GFX_WORD(gfxDecodeWord(curr + 8));
+        curr += GFX_ENCODED_STACK_ENTRY;
+    }
+
+    return size;
+}
\ No newline at end of file
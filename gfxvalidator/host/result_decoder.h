@@ -0,0 +1,14 @@
+#ifndef _GFX_VALIDATOR_HOST_RESULT_DECODER_H
+#define _GFX_VALIDATOR_HOST_RESULT_DECODER_H
+
+#include "../encoding.h"
+
+// reads a big endian word
+u32 gfxDecodeWord(const unsigned char* input);
+
+// decodes one result written by gfxEncodeResult. returns the bytes it used,
+// 0 if input ends before the result does or -1 if input doesn't start with
+// a result this version understands
+int gfxDecodeResult(const unsigned char* input, unsigned length, struct GFXValidationResult* result);
+
+#endif
\ No newline at end of file
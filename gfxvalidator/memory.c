@@ -0,0 +1,50 @@
+
+#include "memory.h"
+
+void* gfxLinearMemoryResolve(struct GFXMemory* memory, u32 address, u32 length) {
+    if (address >= memory->size || length > memory->size - address) {
+        return 0;
+    }
+
+    return (char*)memory->data + address;
+}
+
+void gfxLinearMemoryInit(struct GFXMemory* memory, void* data, u32 size) {
+    memory->resolve = gfxLinearMemoryResolve;
+    memory->size = size;
+    memory->data = data;
+}
+
+void* gfxOverlayMemoryResolve(struct GFXMemory* memory, u32 address, u32 length) {
+    struct GFXOverlayMemory* overlay = (struct GFXOverlayMemory*)memory;
+
+    if (address >= overlay->address && address - overlay->address < overlay->length) {
+        if (length > overlay->length - (address - overlay->address)) {
+            return 0;
+        }
+
+        return (char*)memory->data + (address - overlay->address);
+    }
+
+    // a range that starts before the overlay and runs into it
+    if (address < overlay->address && length > overlay->address - address) {
+        return 0;
+    }
+
+    return gfxMemoryResolve(overlay->base, address, length);
+}
+
+void gfxOverlayMemoryInit(struct GFXOverlayMemory* overlay, struct GFXMemory* base, u32 address, void* data, u32 length) {
+    overlay->memory.resolve = gfxOverlayMemoryResolve;
+    overlay->memory.size = base->size;
+    overlay->memory.data = data;
+    overlay->base = base;
+    overlay->address = address;
+    overlay->length = length;
+}
+
+#ifndef GFX_HOST
+void gfxConsoleMemoryInit(struct GFXMemory* memory) {
+    gfxLinearMemoryInit(memory, (void*)K0BASE, osMemSize);
+}
+#endif
\ No newline at end of file
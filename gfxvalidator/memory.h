@@ -0,0 +1,40 @@
+#ifndef _GFX_VALIDATOR_MEMORY_H
+#define _GFX_VALIDATOR_MEMORY_H
+
+#include <ultra64.h>
+
+struct GFXMemory;
+
+// returns a pointer to length bytes starting at the physical address or 0 if
+// the range isn't backed by memory
+typedef void* (*GFXMemoryResolver)(struct GFXMemory* memory, u32 address, u32 length);
+
+struct GFXMemory {
+    GFXMemoryResolver resolve;
+    // size of RDRAM in bytes
+    u32 size;
+    void* data;
+};
+
+#define gfxMemoryResolve(memory, address, length) ((memory)->resolve((memory), (address), (length)))
+
+void* gfxLinearMemoryResolve(struct GFXMemory* memory, u32 address, u32 length);
+void gfxLinearMemoryInit(struct GFXMemory* memory, void* data, u32 size);
+
+// reads [address, address + length) from data and everything else from base
+// so a modified copy of part of memory can be checked in place
+struct GFXOverlayMemory {
+    struct GFXMemory memory;
+    struct GFXMemory* base;
+    u32 address;
+    u32 length;
+};
+
+void* gfxOverlayMemoryResolve(struct GFXMemory* memory, u32 address, u32 length);
+void gfxOverlayMemoryInit(struct GFXOverlayMemory* overlay, struct GFXMemory* base, u32 address, void* data, u32 length);
+
+#ifndef GFX_HOST
+void gfxConsoleMemoryInit(struct GFXMemory* memory);
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,40 @@
+
+#include "microcode.h"
+
+const struct GFXMicrocode* const gfxMicrocodes[GFXMicrocodeCount] = {
+    [GFXMicrocodeF3D] = &gfxMicrocodeF3D,
+    [GFXMicrocodeF3DEX2] = &gfxMicrocodeF3DEX2,
+};
+
+const struct GFXMicrocode* gfxDefaultMicrocode() {
+#ifdef F3DEX_GBI_2
+    return &gfxMicrocodeF3DEX2;
+#else
+    return &gfxMicrocodeF3D;
+#endif
+}
+
+int gfxSameName(const char* a, const char* b) {
+    for (; *a && *b; ++a, ++b) {
+        char lowerA = *a >= 'A' && *a <= 'Z' ? *a - 'A' + 'a' : *a;
+        char lowerB = *b >= 'A' && *b <= 'Z' ? *b - 'A' + 'a' : *b;
+
+        if (lowerA != lowerB) {
+            return 0;
+        }
+    }
+
+    return *a == *b;
+}
+
+const struct GFXMicrocode* gfxFindMicrocode(const char* name) {
+    int i;
+
+    for (i = 0; i < GFXMicrocodeCount; ++i) {
+        if (gfxSameName(gfxMicrocodes[i]->name, name)) {
+            return gfxMicrocodes[i];
+        }
+    }
+
+    return 0;
+}
\ No newline at end of file
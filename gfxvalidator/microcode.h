@@ -0,0 +1,112 @@
+#ifndef _GFX_VALIDATOR_MICROCODE_H
+#define _GFX_VALIDATOR_MICROCODE_H
+
+#include "validator.h"
+
+enum GFXMicrocodeId {
+    GFXMicrocodeF3D,
+    GFXMicrocodeF3DEX2,
+    GFXMicrocodeCount,
+};
+
+// what a command does, the same kind of command can have a different opcode
+// and encoding in each microcode. RDP commands are the same everywhere and
+// are all GFXCommandRDP
+enum GFXCommandKind {
+    GFXCommandUnknown,
+    GFXCommandSPNoop,
+    GFXCommandMtx,
+    GFXCommandMoveMem,
+    GFXCommandVertex,
+    GFXCommandModifyVertex,
+    GFXCommandDL,
+    GFXCommandEndDL,
+    GFXCommandBranchZ,
+    GFXCommandTri1,
+    GFXCommandTri2,
+    GFXCommandQuad,
+    GFXCommandLine3D,
+    GFXCommandCullDL,
+    GFXCommandPopMtx,
+    GFXCommandMoveWord,
+    GFXCommandTexture,
+    GFXCommandSetOtherModeH,
+    GFXCommandSetOtherModeL,
+    GFXCommandGeometryMode,
+    GFXCommandSetGeometryMode,
+    GFXCommandClearGeometryMode,
+    GFXCommandRDPHalf1,
+    GFXCommandRDPHalf2,
+    GFXCommandRDPHalfCont,
+    GFXCommandLoadUcode,
+    GFXCommandSprite2DBase,
+    GFXCommandSpecial,
+    GFXCommandDmaIO,
+    GFXCommandRDP,
+};
+
+// G_MTX flags as decoded by GFXMicrocode.matrixFlags, the bits in gbi.h are
+// in a different order for each microcode
+#define GFX_MATRIX_PROJECTION   (1 << 0)
+#define GFX_MATRIX_LOAD         (1 << 1)
+#define GFX_MATRIX_PUSH         (1 << 2)
+
+typedef int (*GFXCommandPrinter)(Gfx command, char* output, unsigned maxOutputLength);
+
+struct GFXCommandDescription {
+    // gbi.h name of the opcode, 0 if the microcode doesn't have one
+    const char* name;
+    u8 kind;
+    GFXCommandPrinter print;
+};
+
+// everything that depends on the microcode a display list was built for.
+// each one is compiled from microcode_commands.h so decoding a command is a
+// single table lookup with no checks of which microcode is in use
+struct GFXMicrocode {
+    enum GFXMicrocodeId id;
+    const char* name;
+    u8 vertexBufferSize;
+    // vertex indices in triangle commands are multiplied by this
+    u8 vertexIndexScale;
+    // fields of commands that are read outside of their validators
+    void (*vertexRange)(Gfx* command, int* v0, int* count);
+    void (*otherModeRange)(Gfx* command, int* shift, int* length);
+    void (*moveWordTarget)(Gfx* command, int* index, int* offset);
+    int (*numLights)(u32 data);
+    // GFX_MATRIX_* flags of a G_MTX
+    int (*matrixFlags)(Gfx* command);
+    // matrices removed by a G_POPMTX
+    int (*popCount)(Gfx* command);
+    // returns 1 if a G_MOVEMEM writes part of the combined matrix, offset is
+    // where in the Mtx it starts
+    int (*matrixMove)(Gfx* command, int* offset, int* length);
+    // vertex buffer slots of the triangles drawn by a GFXCommandTri1,
+    // GFXCommandTri2 or GFXCommandQuad, 3 for each. returns the number of
+    // triangles
+    int (*triangles)(Gfx* command, int* vertices);
+    // writes a single command drawing the triangles of both G_TRI1 commands,
+    // 0 if the microcode doesn't have one
+    int (*mergeTriangles)(Gfx* first, Gfx* second, Gfx* output);
+    struct GFXCommandDescription commands[GFX_MAX_COMMAND_LEN];
+    // GFX_MAX_COMMAND_LEN validators for each enum GFXValidationLevel
+    // indexed by opcode, 0 for commands the microcode doesn't have. a level
+    // left out of the build uses the table of the next cheaper one
+    const GFXCommandValidator* validators[GFXValidationLevelCount];
+};
+
+extern const struct GFXMicrocode gfxMicrocodeF3D;
+extern const struct GFXMicrocode gfxMicrocodeF3DEX2;
+// indexed by enum GFXMicrocodeId
+extern const struct GFXMicrocode* const gfxMicrocodes[GFXMicrocodeCount];
+
+#define GFX_COMMAND_DESCRIPTION(microcode, gfx) (&(microcode)->commands[GFX_COMMAND(gfx)])
+#define GFX_COMMAND_KIND(microcode, gfx)        ((microcode)->commands[GFX_COMMAND(gfx)].kind)
+
+// the microcode selected with F3DEX_GBI_2 when the library was built, used
+// when GFXValidatorOptions.microcode isn't set
+const struct GFXMicrocode* gfxDefaultMicrocode();
+// looks up a microcode by name ignoring case, 0 if there isn't one
+const struct GFXMicrocode* gfxFindMicrocode(const char* name);
+
+#endif
\ No newline at end of file
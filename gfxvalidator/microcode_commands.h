@@ -0,0 +1,1537 @@
+// the validators, printers and command table for commands whose encoding
+// depends on the microcode. this is included by microcode_f3d.c and
+// microcode_f3dex2.c, once with F3DEX_GBI_2 defined and once without, so
+// every microcode gets its own copy decoding with constants from gbi.h
+// instead of checking which microcode is in use for each command
+
+#include "validator_internal.h"
+#include "microcode.h"
+#include "format.h"
+#include "gfx_macros.h"
+
+#ifdef F3DEX_GBI_2
+#define GFX_MICROCODE_SUFFIX    F3DEX2
+#else
+#define GFX_MICROCODE_SUFFIX    F3D
+#endif
+
+#define GFX_UCODE_JOIN(name, suffix)    name##suffix
+#define GFX_UCODE_NAME(name, suffix)    GFX_UCODE_JOIN(name, suffix)
+#define GFX_UCODE(name)                 GFX_UCODE_NAME(name, GFX_MICROCODE_SUFFIX)
+
+// each microcode's copy has the suffix added to its name
+#define gfxValidateMtx                        GFX_UCODE(gfxValidateMtx)
+#define gfxValidateMoveMem                    GFX_UCODE(gfxValidateMoveMem)
+#define gfxCheckVertexRange                   GFX_UCODE(gfxCheckVertexRange)
+#define gfxMarkVerticesLoaded                 GFX_UCODE(gfxMarkVerticesLoaded)
+#define gfxValidateVertexCheap                GFX_UCODE(gfxValidateVertexCheap)
+#define gfxValidateVertexStandard             GFX_UCODE(gfxValidateVertexStandard)
+#define gfxCheckVertexIndices                 GFX_UCODE(gfxCheckVertexIndices)
+#define gfxCheckVertexLoaded                  GFX_UCODE(gfxCheckVertexLoaded)
+#define gfxCheckVertices                      GFX_UCODE(gfxCheckVertices)
+#define gfxCheckDraw                          GFX_UCODE(gfxCheckDraw)
+#define gfxCheckTriangleStandard              GFX_UCODE(gfxCheckTriangleStandard)
+#define gfxCheckTriangle                      GFX_UCODE(gfxCheckTriangle)
+#define gfxValidateLine3DCheap                GFX_UCODE(gfxValidateLine3DCheap)
+#define gfxValidateLine3DStandard             GFX_UCODE(gfxValidateLine3DStandard)
+#define gfxValidateLine3D                     GFX_UCODE(gfxValidateLine3D)
+#define gfxCheckModifyVertexIndex             GFX_UCODE(gfxCheckModifyVertexIndex)
+#define gfxCheckModifyVertex                  GFX_UCODE(gfxCheckModifyVertex)
+#define gfxValidateModifyVertexCheap          GFX_UCODE(gfxValidateModifyVertexCheap)
+#define gfxValidateModifyVertex               GFX_UCODE(gfxValidateModifyVertex)
+#define gfxValidateBranchZCheap               GFX_UCODE(gfxValidateBranchZCheap)
+#define gfxValidateBranchZ                    GFX_UCODE(gfxValidateBranchZ)
+#define gfxValidateTri1Cheap                  GFX_UCODE(gfxValidateTri1Cheap)
+#define gfxValidateTri1Standard               GFX_UCODE(gfxValidateTri1Standard)
+#define gfxValidateTri1                       GFX_UCODE(gfxValidateTri1)
+#define gfxValidateTri2Cheap                  GFX_UCODE(gfxValidateTri2Cheap)
+#define gfxValidateTri2Standard               GFX_UCODE(gfxValidateTri2Standard)
+#define gfxValidateTri2                       GFX_UCODE(gfxValidateTri2)
+#define gfxCheckCullRange                     GFX_UCODE(gfxCheckCullRange)
+#define gfxValidateCullDLCheap                GFX_UCODE(gfxValidateCullDLCheap)
+#define gfxValidateCullDL                     GFX_UCODE(gfxValidateCullDL)
+#define gfxValidatePopMtx                     GFX_UCODE(gfxValidatePopMtx)
+#define gfxValidateMoveWordCheap              GFX_UCODE(gfxValidateMoveWordCheap)
+#define gfxValidateMoveWord                   GFX_UCODE(gfxValidateMoveWord)
+#define gfxValidateGeometryMode               GFX_UCODE(gfxValidateGeometryMode)
+#define gfxValidateSetGeometryMode            GFX_UCODE(gfxValidateSetGeometryMode)
+#define gfxValidateClearGeometryMode          GFX_UCODE(gfxValidateClearGeometryMode)
+#define gfxValidateSetOtherModeHCheap         GFX_UCODE(gfxValidateSetOtherModeHCheap)
+#define gfxValidateSetOtherModeLCheap         GFX_UCODE(gfxValidateSetOtherModeLCheap)
+#define gfxValidateSetOtherModeH              GFX_UCODE(gfxValidateSetOtherModeH)
+#define gfxValidateSetOtherModeL              GFX_UCODE(gfxValidateSetOtherModeL)
+#define gfxValidateTexture                    GFX_UCODE(gfxValidateTexture)
+#define gfxDecodeVertexRange                  GFX_UCODE(gfxDecodeVertexRange)
+#define gfxDecodeOtherModeRange               GFX_UCODE(gfxDecodeOtherModeRange)
+#define gfxDecodeMoveWordTarget               GFX_UCODE(gfxDecodeMoveWordTarget)
+#define gfxDecodeNumLights                    GFX_UCODE(gfxDecodeNumLights)
+#define gfxMergeTriangles                     GFX_UCODE(gfxMergeTriangles)
+#define gfxDecodeMatrixFlags                  GFX_UCODE(gfxDecodeMatrixFlags)
+#define gfxDecodePopCount                     GFX_UCODE(gfxDecodePopCount)
+#define gfxDecodeMatrixMove                   GFX_UCODE(gfxDecodeMatrixMove)
+#define gfxDecodeTriangles                    GFX_UCODE(gfxDecodeTriangles)
+#define gfxMtxCommandPrinter                  GFX_UCODE(gfxMtxCommandPrinter)
+#define gfxMoveMemCommandPrinter              GFX_UCODE(gfxMoveMemCommandPrinter)
+#define gfxVtxCommandPrinter                  GFX_UCODE(gfxVtxCommandPrinter)
+#define gfxModifyVertexCommandPrinter         GFX_UCODE(gfxModifyVertexCommandPrinter)
+#define gfxCullDLCommandPrinter               GFX_UCODE(gfxCullDLCommandPrinter)
+#define gfxTri1CommandPrinter                 GFX_UCODE(gfxTri1CommandPrinter)
+#define gfxTri2CommandPrinter                 GFX_UCODE(gfxTri2CommandPrinter)
+#define gfxQuadCommandPrinter                 GFX_UCODE(gfxQuadCommandPrinter)
+#define gfxLine3DCommandPrinter               GFX_UCODE(gfxLine3DCommandPrinter)
+#define gfxBranchZCommandPrinter              GFX_UCODE(gfxBranchZCommandPrinter)
+#define gfxPopMtxCommandPrinter               GFX_UCODE(gfxPopMtxCommandPrinter)
+#define gfxMoveWordCommandPrinter             GFX_UCODE(gfxMoveWordCommandPrinter)
+#define gfxTextureCommandPrinter              GFX_UCODE(gfxTextureCommandPrinter)
+#define gfxSetOtherModeCommandPrinter         GFX_UCODE(gfxSetOtherModeCommandPrinter)
+#define gfxGeometryModeCommandPrinter         GFX_UCODE(gfxGeometryModeCommandPrinter)
+#define gfxSetGeometryModeCommandPrinter      GFX_UCODE(gfxSetGeometryModeCommandPrinter)
+#define gfxClearGeometryModeCommandPrinter    GFX_UCODE(gfxClearGeometryModeCommandPrinter)
+
+enum GFXValidatorError gfxValidateMtx(struct GFXValidatorState* state, Gfx* at) {
+    int flags = DMA_MM_IDX(at);
+
+#ifdef F3DEX_GBI_2
+    flags ^= G_MTX_PUSH;
+#endif
+
+    if (DMA_MM_LEN(at) != DMA_MM_EXPECTED_SIZE(sizeof(Mtx))) {
+        gfxSetReason(state, GFXReasonMatrixMalformed);
+        return GFXValidatorInvalidArguments;
+    } else if (flags < 0 || flags > (G_MTX_PROJECTION | G_MTX_LOAD | G_MTX_PUSH)) {
+        gfxSetReason(state, GFXReasonMatrixFlags);
+        return GFXValidatorInvalidArguments;
+    } else if ((flags & G_MTX_PUSH) && state->pipeline.matrixStackSize == GFX_MAX_MATRIX_STACK) {
+        gfxSetReason(state, GFXReasonMatrixStackOverflow);
+        return GFXValidatorStackOverflow;
+    } else if ((flags & G_MTX_PUSH) && (flags & G_MTX_PROJECTION)) {
+        gfxSetReason(state, GFXReasonProjectionPush);
+        return GFXValidatorInvalidArguments;
+    } else {
+        if (!(flags & G_MTX_LOAD)) {
+            if (flags & G_MTX_PROJECTION) {
+                if (!(state->pipeline.flags & GFX_INITIALIZED_PMTX)) {
+                    gfxSetReason(state, GFXReasonMatrixMultiplyUninitialized);
+                    return GFXValidatorUnitialized;
+                }
+            } else {
+                if (!(state->pipeline.flags & GFX_INITIALIZED_MMTX)) {
+                    gfxSetReason(state, GFXReasonMatrixMultiplyUninitialized);
+                    return GFXValidatorUnitialized;
+                }
+            }
+        }
+
+        if ((flags & G_MTX_PUSH)) {
+            ++state->pipeline.matrixStackSize;
+            GFX_STAT_ADD(state, matrixPushes, 1);
+        }
+
+        GFX_STAT_ADD(state, matrixBytes, sizeof(Mtx));
+
+        if (flags & G_MTX_PROJECTION) {
+            state->pipeline.flags |= GFX_INITIALIZED_PMTX;
+        } else {
+            state->pipeline.flags |= GFX_INITIALIZED_MMTX;
+        }
+
+        return gfxValidateRead(state, DMA_ADDR(at), sizeof(Mtx), 8);
+    }
+}
+
+enum GFXValidatorError gfxValidateMoveMem(struct GFXValidatorState* state, Gfx* at) {
+    int location = DMA_MM_IDX(at);
+    int expectedLen = 0;
+
+    switch (location) {
+        case G_MV_VIEWPORT:
+            expectedLen = DMA_MM_EXPECTED_SIZE(sizeof(Vp));
+            break;
+#ifdef	F3DEX_GBI_2
+        case G_MV_MMTX:
+        case G_MV_PMTX:
+        case G_MV_MATRIX:
+            expectedLen = DMA_MM_EXPECTED_SIZE(16);
+            break;
+        case G_MV_LIGHT:
+            // the offset picks the lookat or light, see G_MVO_*
+            if (DMA_MM_OFS(at) % 24 != 0 || DMA_MM_OFS(at) / 24 >= GFX_LIGHT_SLOT_COUNT) {
+                gfxSetReason(state, GFXReasonLightOffset, DMA_MM_OFS(at));
+                return GFXValidatorInvalidArguments;
+            }
+
+            state->pipeline.loadedLights |= 1 << (DMA_MM_OFS(at) / 24);
+            expectedLen = DMA_MM_EXPECTED_SIZE(sizeof(Light));
+            break;
+        case G_MV_POINT:
+            // Not sure what to expect here
+            expectedLen = DMA_MM_LEN(at);
+            break;
+#else
+        case G_MV_LOOKATY:
+            state->pipeline.loadedLights |= 1 << GFX_LOOKAT_Y_SLOT;
+            expectedLen = sizeof(Light);
+            break;
+        case G_MV_LOOKATX:
+            state->pipeline.loadedLights |= 1 << GFX_LOOKAT_X_SLOT;
+            expectedLen = sizeof(Light);
+            break;
+        case G_MV_L0:
+        case G_MV_L1:
+        case G_MV_L2:
+        case G_MV_L3:
+        case G_MV_L4:
+        case G_MV_L5:
+        case G_MV_L6:
+        case G_MV_L7:
+            state->pipeline.loadedLights |= 1 << (GFX_FIRST_LIGHT_SLOT + ((location - G_MV_L0) >> 1));
+            expectedLen = sizeof(Light);
+            break;
+        case G_MV_TXTATT:
+            // Not sure what to expect here
+            expectedLen = DMA_MM_LEN(at);
+            break;
+        case G_MV_MATRIX_1:
+        case G_MV_MATRIX_2:
+        case G_MV_MATRIX_3:
+        case G_MV_MATRIX_4:
+            expectedLen = 16;
+            break;
+#endif
+        default:
+            gfxSetReason(state, GFXReasonMoveMemTarget);
+            return GFXValidatorInvalidArguments;
+    }
+
+    if (expectedLen != DMA_MM_LEN(at)) {
+        gfxSetReason(state, GFXReasonCopySize);
+        return GFXValidatorInvalidArguments;
+    }
+
+    GFX_STAT_ADD(state, moveMemBytes, DMA_MM_BYTES(at));
+    
+    return gfxValidateRead(state, DMA_ADDR(at), DMA_MM_BYTES(at), 8);
+}
+
+// the checks of a G_VTX every level makes
+enum GFXValidatorError gfxCheckVertexRange(struct GFXValidatorState* state, Gfx* at, int* v0, int* vtxCount) {
+#ifdef F3DEX_GBI_2
+    *vtxCount = _SHIFTR(GFX_W0(at), 12, 8);
+    *v0 = _SHIFTR(GFX_W0(at), 1, 7) - *vtxCount;
+#else
+    *vtxCount = (DMA1_PARAM(at) >> 4) + 1;
+    *v0 = DMA1_PARAM(at) & 0xF;
+
+    if (*vtxCount * sizeof(Vtx) != DMA1_LEN(at)) {
+        gfxSetReason(state, GFXReasonCopySize);
+        return GFXValidatorInvalidArguments;
+    }
+#endif
+
+    if (*vtxCount == 0) {
+        gfxSetReason(state, GFXReasonNoVertices);
+        return GFXValidatorInvalidArguments;
+    }
+
+    if (*v0 + *vtxCount > VERTEX_BUFFER_SIZE) {
+        gfxSetReason(state, GFXReasonVertexBufferOverflow, *v0, *vtxCount);
+        return GFXValidatorInvalidArguments;
+    }
+
+    return GFXValidatorErrorNone;
+}
+
+void gfxMarkVerticesLoaded(struct GFXValidatorState* state, int v0, int vtxCount) {
+    u32 loaded = vtxCount == 32 ? 0xFFFFFFFF : (1u << vtxCount) - 1;
+    state->pipeline.loadedVertices |= loaded << v0;
+}
+
+enum GFXValidatorError gfxValidateVertexCheap(struct GFXValidatorState* state, Gfx* at) {
+    int vtxCount;
+    int v0;
+    enum GFXValidatorError result = gfxCheckVertexRange(state, at, &v0, &vtxCount);
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    // kept at every level so a list sampled at GFXValidationExhaustive
+    // starts out knowing what is loaded
+    gfxMarkVerticesLoaded(state, v0, vtxCount);
+    GFX_STAT_ADD(state, verticesLoaded, vtxCount);
+    GFX_STAT_ADD(state, vertexBytes, vtxCount * sizeof(Vtx));
+
+    return gfxValidateRead(state, DMA_ADDR(at), vtxCount * sizeof(Vtx), 8);
+}
+
+// vertex indices are only checked against the size of the vertex buffer
+enum GFXValidatorError gfxCheckVertexIndices(struct GFXValidatorState* state, int v0, int v1, int v2) {
+    if (v0 >= MAX_VERTEX_VALUE || v1 >= MAX_VERTEX_VALUE || v2 >= MAX_VERTEX_VALUE) {
+        gfxSetReason(state, GFXReasonVertexIndex);
+        return GFXValidatorInvalidArguments;
+    }
+
+    return GFXValidatorErrorNone;
+}
+
+enum GFXValidatorError gfxValidateLine3DCheap(struct GFXValidatorState* state, Gfx* at) {
+#ifdef F3DEX_GBI_2
+    return gfxCheckVertexIndices(state, _SHIFTR(GFX_W0(at), 16, 8), _SHIFTR(GFX_W0(at), 8, 8), _SHIFTR(GFX_W0(at), 8, 8));
+#else
+    return gfxCheckVertexIndices(state, _SHIFTR(GFX_W1(at), 16, 8), _SHIFTR(GFX_W1(at), 8, 8), _SHIFTR(GFX_W1(at), 8, 8));
+#endif
+}
+
+enum GFXValidatorError gfxValidateTri1Cheap(struct GFXValidatorState* state, Gfx* at) {
+#ifdef F3DEX_GBI_2
+    u32 vertices = GFX_W0(at);
+#else
+    u32 vertices = GFX_W1(at);
+#endif
+
+    GFX_STAT_ADD(state, triangles, 1);
+
+    return gfxCheckVertexIndices(state, _SHIFTR(vertices, 16, 8), _SHIFTR(vertices, 8, 8), _SHIFTR(vertices, 0, 8));
+}
+
+enum GFXValidatorError gfxValidateTri2Cheap(struct GFXValidatorState* state, Gfx* at) {
+    GFX_STAT_ADD(state, triangles, 2);
+
+    enum GFXValidatorError result = gfxCheckVertexIndices(state, _SHIFTR(GFX_W0(at), 16, 8), _SHIFTR(GFX_W0(at), 8, 8), _SHIFTR(GFX_W0(at), 0, 8));
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    return gfxCheckVertexIndices(state, _SHIFTR(GFX_W1(at), 16, 8), _SHIFTR(GFX_W1(at), 8, 8), _SHIFTR(GFX_W1(at), 0, 8));
+}
+
+// start and end of a G_CULLDL as vertex indices
+enum GFXValidatorError gfxCheckCullRange(struct GFXValidatorState* state, Gfx* at, int* vstart, int* vend) {
+    *vstart = _SHIFTR(GFX_W0(at), 0, 16);
+    *vend = _SHIFTR(GFX_W1(at), 0, 16);
+
+#ifndef F3DEX_GBI_2
+    // F3D encodes the range as offsets into the vertex buffer and stores
+    // one past the end, masked to the 16 vertex buffer slots
+    *vstart = *vstart / 40 * VERTEX_INDEX_SCALE;
+    *vend = ((*vend / 40 + 15) & 15) * VERTEX_INDEX_SCALE;
+#endif
+
+    if (*vend < *vstart || *vend >= MAX_VERTEX_VALUE) {
+        gfxSetReason(state, GFXReasonCullRange, *vstart / VERTEX_INDEX_SCALE, *vend / VERTEX_INDEX_SCALE);
+        return GFXValidatorInvalidArguments;
+    }
+
+    return GFXValidatorErrorNone;
+}
+
+enum GFXValidatorError gfxValidateCullDLCheap(struct GFXValidatorState* state, Gfx* at) {
+    int vstart;
+    int vend;
+
+    return gfxCheckCullRange(state, at, &vstart, &vend);
+}
+
+enum GFXValidatorError gfxCheckModifyVertexIndex(struct GFXValidatorState* state, int vertex) {
+    if (vertex >= VERTEX_BUFFER_SIZE) {
+        gfxSetReason(state, GFXReasonModifyVertexIndex, vertex);
+        return GFXValidatorInvalidArguments;
+    }
+
+    return GFXValidatorErrorNone;
+}
+
+#ifdef F3DEX_GBI_2
+enum GFXValidatorError gfxValidateModifyVertexCheap(struct GFXValidatorState* state, Gfx* at) {
+    return gfxCheckModifyVertexIndex(state, _SHIFTR(GFX_W0(at), 0, 16) >> 1);
+}
+
+// gsSPBranchLessZ puts the display list to branch to in a G_RDPHALF_1
+// right before the G_BRANCH_Z
+enum GFXValidatorError gfxValidateBranchZCheap(struct GFXValidatorState* state, Gfx* at) {
+    if (!(state->pipeline.flags & GFX_INITIALIZED_RDPHALF1)) {
+        gfxSetReason(state, GFXReasonBranchZNoAddress);
+        return GFXValidatorUnitialized;
+    }
+
+    int vertex = _SHIFTR(GFX_W0(at), 0, 12);
+    enum GFXValidatorError result = gfxCheckVertexIndices(state, vertex, vertex, vertex);
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    return gfxValidateAddress(state, state->pipeline.rdpHalf1, sizeof(Gfx), 8);
+}
+#endif
+
+#ifndef GFX_DISABLE_STANDARD_VALIDATION
+enum GFXValidatorError gfxValidateVertexStandard(struct GFXValidatorState* state, Gfx* at) {
+    int vtxCount;
+    int v0;
+    enum GFXValidatorError result = gfxCheckVertexRange(state, at, &v0, &vtxCount);
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    if (state->pipeline.geometryMode & G_LIGHTING) {
+        result = gfxCheckLighting(state);
+
+        if (result != GFXValidatorErrorNone) {
+            return result;
+        }
+    }
+
+    gfxMarkVerticesLoaded(state, v0, vtxCount);
+    GFX_STAT_ADD(state, verticesLoaded, vtxCount);
+    GFX_STAT_ADD(state, vertexBytes, vtxCount * sizeof(Vtx));
+
+    return gfxValidateRead(state, DMA_ADDR(at), vtxCount * sizeof(Vtx), 8);
+}
+
+// what drawing a primitive depends on besides the vertex buffer
+enum GFXValidatorError gfxCheckDraw(struct GFXValidatorState* state) {
+    gfxRecordPrimitive(state, gfxPrimitiveTiles(state));
+
+    // display lists validated on their own may draw into a color image
+    // bound by whoever calls them
+    if (!(state->pipeline.flags & GFX_INITIALIZED_CIMG)) {
+        return GFXValidatorErrorNone;
+    }
+
+    return gfxCheckRenderTarget(state);
+}
+
+enum GFXValidatorError gfxCheckTriangleStandard(struct GFXValidatorState* state, int v0, int v1, int v2) {
+    enum GFXValidatorError result = gfxCheckVertexIndices(state, v0, v1, v2);
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    return gfxCheckDraw(state);
+}
+
+enum GFXValidatorError gfxValidateLine3DStandard(struct GFXValidatorState* state, Gfx* at) {
+#ifdef F3DEX_GBI_2
+    return gfxCheckTriangleStandard(state, _SHIFTR(GFX_W0(at), 16, 8), _SHIFTR(GFX_W0(at), 8, 8), _SHIFTR(GFX_W0(at), 8, 8));
+#else
+    return gfxCheckTriangleStandard(state, _SHIFTR(GFX_W1(at), 16, 8), _SHIFTR(GFX_W1(at), 8, 8), _SHIFTR(GFX_W1(at), 8, 8));
+#endif
+}
+
+enum GFXValidatorError gfxValidateTri1Standard(struct GFXValidatorState* state, Gfx* at) {
+#ifdef F3DEX_GBI_2
+    u32 vertices = GFX_W0(at);
+#else
+    u32 vertices = GFX_W1(at);
+#endif
+
+    GFX_STAT_ADD(state, triangles, 1);
+
+    return gfxCheckTriangleStandard(state, _SHIFTR(vertices, 16, 8), _SHIFTR(vertices, 8, 8), _SHIFTR(vertices, 0, 8));
+}
+
+enum GFXValidatorError gfxValidateTri2Standard(struct GFXValidatorState* state, Gfx* at) {
+    GFX_STAT_ADD(state, triangles, 2);
+
+    enum GFXValidatorError result = gfxCheckTriangleStandard(state, _SHIFTR(GFX_W0(at), 16, 8), _SHIFTR(GFX_W0(at), 8, 8), _SHIFTR(GFX_W0(at), 0, 8));
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    return gfxCheckTriangleStandard(state, _SHIFTR(GFX_W1(at), 16, 8), _SHIFTR(GFX_W1(at), 8, 8), _SHIFTR(GFX_W1(at), 0, 8));
+}
+#endif // GFX_DISABLE_STANDARD_VALIDATION
+
+#ifndef GFX_DISABLE_EXHAUSTIVE_VALIDATION
+enum GFXValidatorError gfxCheckVertexLoaded(struct GFXValidatorState* state, int index) {
+    if (state->pipeline.loadedVertices & VERTEX_SLOT_BIT(index)) {
+        return GFXValidatorErrorNone;
+    }
+
+    gfxSetReason(state, GFXReasonVertexNotLoaded, index / VERTEX_INDEX_SCALE);
+    return GFXValidatorUnitialized;
+}
+
+enum GFXValidatorError gfxCheckVertices(struct GFXValidatorState* state, int v0, int v1, int v2) {
+    enum GFXValidatorError result = gfxCheckVertexIndices(state, v0, v1, v2);
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    u32 used = VERTEX_SLOT_BIT(v0) | VERTEX_SLOT_BIT(v1) | VERTEX_SLOT_BIT(v2);
+
+    if ((state->pipeline.loadedVertices & used) == used) {
+        return GFXValidatorErrorNone;
+    }
+
+    // only reached on failure, find which vertex to report
+    if (gfxCheckVertexLoaded(state, v0) != GFXValidatorErrorNone) {
+        return GFXValidatorUnitialized;
+    } else if (gfxCheckVertexLoaded(state, v1) != GFXValidatorErrorNone) {
+        return GFXValidatorUnitialized;
+    } else {
+        return gfxCheckVertexLoaded(state, v2);
+    }
+}
+
+enum GFXValidatorError gfxCheckTriangle(struct GFXValidatorState* state, int v0, int v1, int v2) {
+    enum GFXValidatorError result = gfxCheckVertices(state, v0, v1, v2);
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    return gfxCheckDraw(state);
+}
+
+enum GFXValidatorError gfxValidateLine3D(struct GFXValidatorState* state, Gfx* at) {
+#ifdef F3DEX_GBI_2
+    return gfxCheckTriangle(state, _SHIFTR(GFX_W0(at), 16, 8), _SHIFTR(GFX_W0(at), 8, 8), _SHIFTR(GFX_W0(at), 8, 8));
+#else
+    return gfxCheckTriangle(state, _SHIFTR(GFX_W1(at), 16, 8), _SHIFTR(GFX_W1(at), 8, 8), _SHIFTR(GFX_W1(at), 8, 8));
+#endif
+}
+
+enum GFXValidatorError gfxCheckModifyVertex(struct GFXValidatorState* state, int vertex) {
+    enum GFXValidatorError result = gfxCheckModifyVertexIndex(state, vertex);
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    return gfxCheckVertexLoaded(state, vertex * VERTEX_INDEX_SCALE);
+}
+
+#ifdef F3DEX_GBI_2
+enum GFXValidatorError gfxValidateModifyVertex(struct GFXValidatorState* state, Gfx* at) {
+    return gfxCheckModifyVertex(state, _SHIFTR(GFX_W0(at), 0, 16) >> 1);
+}
+
+enum GFXValidatorError gfxValidateBranchZ(struct GFXValidatorState* state, Gfx* at) {
+    enum GFXValidatorError result = gfxValidateBranchZCheap(state, at);
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    // the depth compared against is the vertex's screen z
+    return gfxCheckVertexLoaded(state, _SHIFTR(GFX_W0(at), 0, 12));
+}
+#endif
+
+enum GFXValidatorError gfxValidateTri1(struct GFXValidatorState* state, Gfx* at) {
+#ifdef F3DEX_GBI_2
+    u32 vertices = GFX_W0(at);
+#else
+    u32 vertices = GFX_W1(at);
+#endif
+
+    GFX_STAT_ADD(state, triangles, 1);
+
+    return gfxCheckTriangle(state, _SHIFTR(vertices, 16, 8), _SHIFTR(vertices, 8, 8), _SHIFTR(vertices, 0, 8));
+}
+
+enum GFXValidatorError gfxValidateTri2(struct GFXValidatorState* state, Gfx* at) {
+    GFX_STAT_ADD(state, triangles, 2);
+
+    enum GFXValidatorError result = gfxCheckTriangle(
+        state, 
+        _SHIFTR(GFX_W0(at), 16, 8), 
+        _SHIFTR(GFX_W0(at), 8, 8), 
+        _SHIFTR(GFX_W0(at), 0, 8)
+    );
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    result = gfxCheckTriangle(
+        state, 
+        _SHIFTR(GFX_W1(at), 16, 8), 
+        _SHIFTR(GFX_W1(at), 8, 8), 
+        _SHIFTR(GFX_W1(at), 0, 8)
+    );
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    return GFXValidatorErrorNone;
+}
+
+enum GFXValidatorError gfxValidateCullDL(struct GFXValidatorState* state, Gfx* at) {
+    int vstart;
+    int vend;
+    enum GFXValidatorError result = gfxCheckCullRange(state, at, &vstart, &vend);
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    int first = vstart / VERTEX_INDEX_SCALE;
+    int last = vend / VERTEX_INDEX_SCALE;
+    // every slot in [first, last], shifting 2 past bit 31 leaves 0
+    u32 used = ((2u << last) - 1) & ~((1u << first) - 1);
+    u32 missing = used & ~state->pipeline.loadedVertices;
+
+    if (!missing) {
+        return GFXValidatorErrorNone;
+    }
+
+    // report the first slot that wasn't loaded
+    while (!(missing & (1u << first))) {
+        ++first;
+    }
+
+    gfxSetReason(state, GFXReasonVertexNotLoaded, first);
+    return GFXValidatorUnitialized;
+}
+#endif // GFX_DISABLE_EXHAUSTIVE_VALIDATION
+
+enum GFXValidatorError gfxValidatePopMtx(struct GFXValidatorState* state, Gfx* at) {
+    // TODO handle G_SPRITE2D_DRAW in sprite mode
+    int popCount;
+#ifdef F3DEX_GBI_2
+    popCount = GFX_W1(at) >> 6;
+#else
+    popCount = 1;
+#endif
+
+    if (state->pipeline.matrixStackSize < popCount) {
+        gfxSetReason(state, GFXReasonMatrixStackUnderflow);
+        return GFXValidatorStackUnderflow;
+#ifndef F3DEX_GBI_2
+    } else if (GFX_W1(at) != G_MTX_MODELVIEW) {
+        return GFXValidatorInvalidArguments;
+#endif
+    } else {
+        state->pipeline.matrixStackSize -= popCount;
+        GFX_STAT_ADD(state, matrixPops, popCount);
+        return GFXValidatorErrorNone;
+    }
+}
+
+
+enum GFXValidatorError gfxValidateMoveWordCheap(struct GFXValidatorState* state, Gfx* at) {
+    int index = MOVE_WORD_IDX(at);
+    int offset = MOVE_WORD_OFS(at);
+    int data = MOVE_WORD_DATA(at);
+
+    switch (index) {
+        case G_MW_SEGMENT:
+            if (offset > GFX_MAX_SEGMENTS * 4 || offset < 0) {
+                gfxSetReason(state, GFXReasonSegmentIndex, offset >> 2);
+                return GFXValidatorInvalidArguments;
+            } else if (!gfxIsValidSegmentAddress(state, data)) {
+                gfxSetReason(state, GFXReasonSegmentAddress, data);
+                return GFXValidatorInvalidArguments;
+            }
+
+            state->pipeline.segments[offset>>2] = data;
+            break;
+        case G_MW_CLIP:
+            break;
+        case G_MW_MATRIX:
+            break;
+#ifdef F3DEX_GBI_2
+        case G_MW_FORCEMTX:
+            break;
+#else
+        case G_MW_POINTS:
+            return gfxCheckModifyVertexIndex(state, offset / 40);
+#endif // F3DEX_GBI_2
+        case G_MW_NUMLIGHT:
+            if (NUM_LIGHTS(data) < 0 || NUM_LIGHTS(data) > GFX_MAX_LIGHTS) {
+                gfxSetReason(state, GFXReasonLightCount, NUM_LIGHTS(data));
+                return GFXValidatorInvalidArguments;
+            }
+
+            state->pipeline.numLights = NUM_LIGHTS(data);
+            state->pipeline.flags |= GFX_INITIALIZED_NUMLIGHT;
+            break;
+        case G_MW_LIGHTCOL:
+            break;
+        case G_MW_FOG:
+            break;
+        case G_MW_PERSPNORM:
+            break;
+        default:
+            return GFXValidatorInvalidArguments;
+    }
+    
+    return GFXValidatorErrorNone;
+}
+
+#if !defined(F3DEX_GBI_2) && !defined(GFX_DISABLE_EXHAUSTIVE_VALIDATION)
+// G_MW_POINTS modifies a vertex that has to be loaded, F3DEX2 uses
+// gfxValidateMoveWordCheap at every level
+enum GFXValidatorError gfxValidateMoveWord(struct GFXValidatorState* state, Gfx* at) {
+    if (MOVE_WORD_IDX(at) == G_MW_POINTS) {
+        return gfxCheckModifyVertex(state, MOVE_WORD_OFS(at) / 40);
+    }
+
+    return gfxValidateMoveWordCheap(state, at);
+}
+#endif
+
+#ifdef F3DEX_GBI_2
+enum GFXValidatorError gfxValidateGeometryMode(struct GFXValidatorState* state, Gfx* at) {
+    state->pipeline.geometryMode = (state->pipeline.geometryMode & _SHIFTR(GFX_W0(at), 0, 24)) | GFX_W1(at);
+    return GFXValidatorErrorNone;
+}
+#else
+enum GFXValidatorError gfxValidateSetGeometryMode(struct GFXValidatorState* state, Gfx* at) {
+    state->pipeline.geometryMode |= GFX_W1(at);
+    return GFXValidatorErrorNone;
+}
+
+enum GFXValidatorError gfxValidateClearGeometryMode(struct GFXValidatorState* state, Gfx* at) {
+    state->pipeline.geometryMode &= ~GFX_W1(at);
+    return GFXValidatorErrorNone;
+}
+#endif
+
+enum GFXValidatorError gfxValidateSetOtherModeHCheap(struct GFXValidatorState* state, Gfx* at) {
+    return gfxSetOtherModeBits(state, &state->pipeline.othermodeH, OTHERMODE_SFT(at), OTHERMODE_LEN(at), GFX_W1(at));
+}
+
+enum GFXValidatorError gfxValidateSetOtherModeLCheap(struct GFXValidatorState* state, Gfx* at) {
+    return gfxSetOtherModeBits(state, &state->pipeline.othermodeL, OTHERMODE_SFT(at), OTHERMODE_LEN(at), GFX_W1(at));
+}
+
+#ifndef GFX_DISABLE_STANDARD_VALIDATION
+enum GFXValidatorError gfxValidateSetOtherModeH(struct GFXValidatorState* state, Gfx* at) {
+    return gfxSetOtherMode(state, &state->pipeline.othermodeH, OTHERMODE_SFT(at), OTHERMODE_LEN(at), GFX_W1(at));
+}
+
+enum GFXValidatorError gfxValidateSetOtherModeL(struct GFXValidatorState* state, Gfx* at) {
+    return gfxSetOtherMode(state, &state->pipeline.othermodeL, OTHERMODE_SFT(at), OTHERMODE_LEN(at), GFX_W1(at));
+}
+#endif
+
+enum GFXValidatorError gfxValidateTexture(struct GFXValidatorState* state, Gfx* at) {
+    state->pipeline.textureTile = TEXTURE_TILE(at);
+    state->pipeline.textureLevels = TEXTURE_LEVEL(at);
+    state->pipeline.textureOn = TEXTURE_ON(at) != 0;
+    return GFXValidatorErrorNone;
+}
+
+void gfxDecodeVertexRange(Gfx* command, int* v0, int* count) {
+#ifdef F3DEX_GBI_2
+    *count = _SHIFTR(GFX_W0(command), 12, 8);
+    *v0 = _SHIFTR(GFX_W0(command), 1, 7) - *count;
+#else
+    *count = (DMA1_PARAM(command) >> 4) + 1;
+    *v0 = DMA1_PARAM(command) & 0xF;
+#endif
+}
+
+void gfxDecodeOtherModeRange(Gfx* command, int* shift, int* length) {
+    *shift = OTHERMODE_SFT(command);
+    *length = OTHERMODE_LEN(command);
+}
+
+void gfxDecodeMoveWordTarget(Gfx* command, int* index, int* offset) {
+    *index = MOVE_WORD_IDX(command);
+    *offset = MOVE_WORD_OFS(command);
+}
+
+int gfxDecodeNumLights(u32 data) {
+    return NUM_LIGHTS(data);
+}
+
+int gfxDecodeMatrixFlags(Gfx* command) {
+    int flags = DMA_MM_IDX(command);
+
+#ifdef F3DEX_GBI_2
+    flags ^= G_MTX_PUSH;
+#endif
+
+    return ((flags & G_MTX_PROJECTION) ? GFX_MATRIX_PROJECTION : 0) |
+        ((flags & G_MTX_LOAD) ? GFX_MATRIX_LOAD : 0) |
+        ((flags & G_MTX_PUSH) ? GFX_MATRIX_PUSH : 0);
+}
+
+int gfxDecodePopCount(Gfx* command) {
+#ifdef F3DEX_GBI_2
+    return GFX_W1(command) >> 6;
+#else
+    return 1;
+#endif
+}
+
+int gfxDecodeMatrixMove(Gfx* command, int* offset, int* length) {
+#ifdef F3DEX_GBI_2
+    if (DMA_MM_IDX(command) != G_MV_MATRIX) {
+        return 0;
+    }
+
+    *offset = DMA_MM_OFS(command);
+    *length = DMA_MM_BYTES(command);
+#else
+    // gSPForceMatrix loads the matrix a quarter at a time
+    switch (DMA_MM_IDX(command)) {
+        case G_MV_MATRIX_1: *offset = 0; break;
+        case G_MV_MATRIX_2: *offset = 16; break;
+        case G_MV_MATRIX_3: *offset = 32; break;
+        case G_MV_MATRIX_4: *offset = 48; break;
+        default:
+            return 0;
+    }
+
+    *length = 16;
+#endif
+
+    return 1;
+}
+
+int gfxDecodeTriangles(Gfx* command, int* vertices) {
+#ifdef F3DEX_GBI_2
+    u32 first = GFX_W0(command);
+#else
+    u32 first = GFX_W1(command);
+#endif
+    int count = 1;
+
+    vertices[0] = _SHIFTR(first, 16, 8) / VERTEX_INDEX_SCALE;
+    vertices[1] = _SHIFTR(first, 8, 8) / VERTEX_INDEX_SCALE;
+    vertices[2] = _SHIFTR(first, 0, 8) / VERTEX_INDEX_SCALE;
+
+#ifdef G_TRI2
+    if (GFX_COMMAND(command) != (u8)G_TRI1) {
+        vertices[3] = _SHIFTR(GFX_W1(command), 16, 8) / VERTEX_INDEX_SCALE;
+        vertices[4] = _SHIFTR(GFX_W1(command), 8, 8) / VERTEX_INDEX_SCALE;
+        vertices[5] = _SHIFTR(GFX_W1(command), 0, 8) / VERTEX_INDEX_SCALE;
+        count = 2;
+    }
+#endif
+
+    return count;
+}
+
+#ifdef F3DEX_GBI_2
+int gfxMergeTriangles(Gfx* first, Gfx* second, Gfx* output) {
+    output->words.w0 = GFX_WORD(_SHIFTL(G_TRI2, 24, 8) | (GFX_W0(first) & 0xFFFFFF));
+    output->words.w1 = GFX_WORD(GFX_W0(second) & 0xFFFFFF);
+    return 1;
+}
+#endif
+
+int gfxMtxCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    int flags = DMA_MM_IDX(&command);
+
+#ifdef F3DEX_GBI_2
+    flags ^= G_MTX_PUSH;
+#endif
+
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsSPMatrix(0x%08x, %s | %s | %s)",
+        GFX_W1(&command),
+        (flags & G_MTX_PROJECTION) ? "G_MTX_PROJECTION" : "G_MTX_MODELVIEW",
+        (flags & G_MTX_LOAD) ? "G_MTX_LOAD" : "G_MTX_MUL",
+        (flags & G_MTX_PUSH) ? "G_MTX_PUSH" : "G_MTX_NOPUSH"
+    );
+}
+
+int gfxMoveMemCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    int location = DMA_MM_IDX(&command);
+
+    switch (location) {
+        case G_MV_VIEWPORT:
+            return gfxFormat(
+                output,
+                maxOutputLength,
+                "gsSPViewport(0x%08x)",
+                GFX_W1(&command)
+            );
+#ifdef	F3DEX_GBI_2
+        case G_MV_MATRIX:
+            return gfxFormat(
+                output,
+                maxOutputLength,
+                "gsSPForceMatrix(0x%08x)",
+                GFX_W1(&command)
+            );
+        case G_MV_LIGHT:
+            // the offset picks the lookat or light, see G_MVO_*
+            switch (DMA_MM_OFS(&command)) {
+                case G_MVO_LOOKATX:
+                    return gfxFormat(
+                        output,
+                        maxOutputLength,
+                        "gsSPLookAtX(0x%08x)",
+                        GFX_W1(&command)
+                    );
+                case G_MVO_LOOKATY:
+                    return gfxFormat(
+                        output,
+                        maxOutputLength,
+                        "gsSPLookAtY(0x%08x)",
+                        GFX_W1(&command)
+                    );
+                default:
+                    return gfxFormat(
+                        output,
+                        maxOutputLength,
+                        "gsSPLight(0x%08x, %d)",
+                        GFX_W1(&command),
+                        DMA_MM_OFS(&command) / 24 - 1
+                    );
+            }
+#else
+        case G_MV_LOOKATX:
+            return gfxFormat(
+                output,
+                maxOutputLength,
+                "gsSPLookAtX(0x%08x)",
+                GFX_W1(&command)
+            );
+        case G_MV_LOOKATY:
+            return gfxFormat(
+                output,
+                maxOutputLength,
+                "gsSPLookAtY(0x%08x)",
+                GFX_W1(&command)
+            );
+        case G_MV_L0:
+        case G_MV_L1:
+        case G_MV_L2:
+        case G_MV_L3:
+        case G_MV_L4:
+        case G_MV_L5:
+        case G_MV_L6:
+        case G_MV_L7:
+            return gfxFormat(
+                output,
+                maxOutputLength,
+                "gsSPLight(0x%08x, %d)",
+                GFX_W1(&command),
+                ((location - G_MV_L0) >> 1) + 1
+            );
+#endif
+        default:
+            return gfxFormat(
+                output,
+                maxOutputLength,
+                "gsDma2p(G_MOVEMEM, 0x%08x, *, 0x%x, %d)",
+                GFX_W1(&command),
+                location,
+                DMA_MM_OFS(&command)
+            );
+    }
+}
+
+int gfxVtxCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    int vtxCount;
+    int v0;
+#ifdef F3DEX_GBI_2
+    vtxCount = _SHIFTR(GFX_W0(&command), 12, 8);
+    v0 = _SHIFTR(GFX_W0(&command), 1, 7) - vtxCount;
+#else
+    vtxCount = (DMA1_PARAM(&command) >> 4) + 1;
+    v0 = DMA1_PARAM(&command) & 0xF;
+#endif
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsSPVertex(0x%08x, %d, %d)",
+        GFX_W1(&command),
+        vtxCount,
+        v0
+    );
+}
+
+#ifdef F3DEX_GBI_2
+int gfxModifyVertexCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsSPModifyVertex(%d, 0x%02x, 0x%08x)",
+        _SHIFTR(GFX_W0(&command), 0, 16) >> 1,
+        _SHIFTR(GFX_W0(&command), 16, 8),
+        GFX_W1(&command)
+    );
+}
+#endif
+
+int gfxCullDLCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    int vstart = _SHIFTR(GFX_W0(&command), 0, 16);
+    int vend = _SHIFTR(GFX_W1(&command), 0, 16);
+
+#ifdef F3DEX_GBI_2
+    vstart /= VERTEX_INDEX_SCALE;
+    vend /= VERTEX_INDEX_SCALE;
+#else
+    // F3D encodes the range as offsets into the vertex buffer
+    vstart /= 40;
+    vend = (vend / 40 + 15) & 15;
+#endif
+
+    return gfxFormat(output, maxOutputLength, "gsSPCullDisplayList(%d, %d)", vstart, vend);
+}
+
+int gfxTri1CommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+#ifdef F3DEX_GBI_2
+    u32 vertices = GFX_W0(&command);
+#else
+    u32 vertices = GFX_W1(&command);
+#endif
+
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsSP1Triangle(%d, %d, %d, 0)",
+        _SHIFTR(vertices, 16, 8) / VERTEX_INDEX_SCALE,
+        _SHIFTR(vertices, 8, 8) / VERTEX_INDEX_SCALE,
+        _SHIFTR(vertices, 0, 8) / VERTEX_INDEX_SCALE
+    );
+}
+
+int gfxTri2CommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsSP2Triangles(%d, %d, %d, 0, %d, %d, %d, 0)",
+        _SHIFTR(GFX_W0(&command), 16, 8) / VERTEX_INDEX_SCALE,
+        _SHIFTR(GFX_W0(&command), 8, 8) / VERTEX_INDEX_SCALE,
+        _SHIFTR(GFX_W0(&command), 0, 8) / VERTEX_INDEX_SCALE,
+        _SHIFTR(GFX_W1(&command), 16, 8) / VERTEX_INDEX_SCALE,
+        _SHIFTR(GFX_W1(&command), 8, 8) / VERTEX_INDEX_SCALE,
+        _SHIFTR(GFX_W1(&command), 0, 8) / VERTEX_INDEX_SCALE
+    );
+}
+
+int gfxQuadCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    // stored as the triangles (v0, v1, v2) and (v0, v2, v3)
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsSP1Quadrangle(%d, %d, %d, %d, 0)",
+        _SHIFTR(GFX_W0(&command), 16, 8) / VERTEX_INDEX_SCALE,
+        _SHIFTR(GFX_W0(&command), 8, 8) / VERTEX_INDEX_SCALE,
+        _SHIFTR(GFX_W0(&command), 0, 8) / VERTEX_INDEX_SCALE,
+        _SHIFTR(GFX_W1(&command), 0, 8) / VERTEX_INDEX_SCALE
+    );
+}
+
+int gfxLine3DCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+#ifdef F3DEX_GBI_2
+    u32 vertices = GFX_W0(&command);
+#else
+    u32 vertices = GFX_W1(&command);
+#endif
+
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsSPLineW3D(%d, %d, %d, 0)",
+        _SHIFTR(vertices, 16, 8) / VERTEX_INDEX_SCALE,
+        _SHIFTR(vertices, 8, 8) / VERTEX_INDEX_SCALE,
+        _SHIFTR(vertices, 0, 8)
+    );
+}
+
+int gfxBranchZCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    // the display list to branch to is in the G_RDPHALF_1 before this
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsSPBranchLessZraw(*, %d, 0x%08x)",
+        _SHIFTR(GFX_W0(&command), 0, 12) / VERTEX_INDEX_SCALE,
+        GFX_W1(&command)
+    );
+}
+
+int gfxPopMtxCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    int popCount;
+#ifdef F3DEX_GBI_2
+    popCount = GFX_W1(&command) >> 6;
+#else
+    popCount = 1;
+#endif
+
+    if (popCount == 1) {
+        return gfxFormat(
+            output,
+            maxOutputLength,
+            "gsSPPopMatrix(G_MTX_MODELVIEW)"
+        );
+    }
+
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsSPPopMatrixN(G_MTX_MODELVIEW, %d)",
+        popCount
+    );
+}
+
+int gfxMoveWordCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    int index = MOVE_WORD_IDX(&command);
+    int offset = MOVE_WORD_OFS(&command);
+    u32 data = MOVE_WORD_DATA(&command);
+
+    switch (index) {
+        case G_MW_SEGMENT:
+            return gfxFormat(
+                output,
+                maxOutputLength,
+                "gsSPSegment(0x%x, 0x%08x)",
+                offset >> 2,
+                data
+            );
+        case G_MW_CLIP:
+            return gfxFormat(
+                output,
+                maxOutputLength,
+                "gsSPClipRatio(*)"
+            );
+        case G_MW_MATRIX:
+            return gfxFormat(
+                output,
+                maxOutputLength,
+                "gsSPInsertMatrix(0x%x, 0x%08x)",
+                offset,
+                data
+            );
+#ifdef F3DEX_GBI_2
+        case G_MW_FORCEMTX:
+            return gfxFormat(
+                output,
+                maxOutputLength,
+                "gsMoveWd(G_MW_FORCEMTX, 0, %d)",
+                data
+            );
+#else
+        case G_MW_POINTS:
+            return gfxFormat(
+                output,
+                maxOutputLength,
+                "gsSPModifyVertex(%d, 0x%02x, 0x%08x)",
+                offset / 40,
+                offset % 40,
+                data
+            );
+#endif // F3DEX_GBI_2
+        case G_MW_NUMLIGHT:
+            return gfxFormat(
+                output,
+                maxOutputLength,
+                "gsSPNumLights(%d)",
+                NUM_LIGHTS(data)
+            );
+        case G_MW_LIGHTCOL:
+            return gfxFormat(
+                output,
+                maxOutputLength,
+                "gsSPLightColor(0x%x, 0x%08x)",
+                offset,
+                data
+            );
+        case G_MW_FOG:
+            return gfxFormat(
+                output,
+                maxOutputLength,
+                "gsSPFogFactor(%d, %d)",
+                (s16)(data >> 16),
+                (s16)(data & 0xFFFF)
+            );
+        case G_MW_PERSPNORM:
+            return gfxFormat(
+                output,
+                maxOutputLength,
+                "gsSPPerspNormalize(%d)",
+                data
+            );
+        default:
+            return gfxFormat(
+                output,
+                maxOutputLength,
+                "gsMoveWd(%d, %d, 0x%08x)",
+                index,
+                offset,
+                data
+            );
+    }
+}
+
+int gfxTextureCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsSPTexture(0x%04x, 0x%04x, %d, %d, %s)",
+        _SHIFTR(GFX_W1(&command), 16, 16),
+        _SHIFTR(GFX_W1(&command), 0, 16),
+        TEXTURE_LEVEL(&command),
+        TEXTURE_TILE(&command),
+        TEXTURE_ON(&command) ? "G_ON" : "G_OFF"
+    );
+}
+
+int gfxSetOtherModeCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsSPSetOtherMode(%s, %d, %d, 0x%08x)",
+        GFX_COMMAND(&command) == (u8)G_SETOTHERMODE_H ? "G_SETOTHERMODE_H" : "G_SETOTHERMODE_L",
+        OTHERMODE_SFT(&command),
+        OTHERMODE_LEN(&command),
+        GFX_W1(&command)
+    );
+}
+
+#ifdef F3DEX_GBI_2
+int gfxGeometryModeCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(
+        output,
+        maxOutputLength,
+        "gsSPGeometryMode(0x%08x, 0x%08x)",
+        ~GFX_W0(&command) & 0x00FFFFFF,
+        GFX_W1(&command)
+    );
+}
+#else
+int gfxSetGeometryModeCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(output, maxOutputLength, "gsSPSetGeometryMode(0x%08x)", GFX_W1(&command));
+}
+
+int gfxClearGeometryModeCommandPrinter(Gfx command, char* output, unsigned maxOutputLength) {
+    return gfxFormat(output, maxOutputLength, "gsSPClearGeometryMode(0x%08x)", GFX_W1(&command));
+}
+#endif
+
+// only what can be checked from the command itself, see GFXValidationCheap
+const GFXCommandValidator GFX_UCODE(gfxCheapValidators)[GFX_MAX_COMMAND_LEN] = {
+    [G_SPNOOP] = gfxValidateNoop,
+    [G_MTX] = gfxValidateMtx,
+    [G_MOVEMEM] = gfxValidateMoveMem,
+    [G_VTX] = gfxValidateVertexCheap,
+    [G_DL] = gfxValidateDL,
+#ifdef G_SPRITE2D_BASE
+    [G_SPRITE2D_BASE] = gfxValidateSprite2DBase,
+#endif
+
+    [(u8)G_TRI1] = gfxValidateTri1Cheap,
+#ifdef G_TRI2
+    [(u8)G_TRI2] = gfxValidateTri2Cheap,
+#endif
+    [(u8)G_CULLDL] = gfxValidateCullDLCheap,
+    [(u8)G_POPMTX] = gfxValidatePopMtx,
+    [(u8)G_MOVEWORD] = gfxValidateMoveWordCheap,
+    [(u8)G_TEXTURE] = gfxValidateTexture,
+    [(u8)G_SETOTHERMODE_H] = gfxValidateSetOtherModeHCheap,
+    [(u8)G_SETOTHERMODE_L] = gfxValidateSetOtherModeLCheap,
+    [(u8)G_ENDDL] = gfxValidateTODO,
+    [(u8)G_LINE3D] = gfxValidateLine3DCheap,
+    [(u8)G_RDPHALF_1] = gfxValidateRDPHalf1,
+    [(u8)G_RDPHALF_2] = gfxValidateTODO,
+#ifdef F3DEX_GBI_2
+    [(u8)G_MODIFYVTX] = gfxValidateModifyVertexCheap,
+    [(u8)G_BRANCH_Z] = gfxValidateBranchZCheap,
+    [(u8)G_QUAD] = gfxValidateTri2Cheap,
+    [(u8)G_SPECIAL_1] = gfxValidateTODO,
+    [(u8)G_SPECIAL_2] = gfxValidateTODO,
+    [(u8)G_SPECIAL_3] = gfxValidateTODO,
+    [(u8)G_DMA_IO] = gfxValidateTODO,
+    [(u8)G_LOAD_UCODE] = gfxValidateTODO,
+    [(u8)G_GEOMETRYMODE] = gfxValidateGeometryMode,
+#else
+    [(u8)G_SETGEOMETRYMODE] = gfxValidateSetGeometryMode,
+    [(u8)G_CLEARGEOMETRYMODE] = gfxValidateClearGeometryMode,
+    [(u8)G_RDPHALF_CONT] = gfxValidateTODO,
+#endif
+
+    [(u8)G_NOOP] = gfxValidateRDPNoop,
+
+    [(u8)G_SETCIMG] = gfxValidateSetColorImageCheap,
+    [(u8)G_SETZIMG] = gfxValidateSetDepthImageCheap,
+    [(u8)G_SETTIMG] = gfxValidateSetTextureImage,
+    [(u8)G_SETCOMBINE] = gfxValidateTODO,
+    [(u8)G_SETENVCOLOR] = gfxValidateTODO,
+    [(u8)G_SETPRIMCOLOR] = gfxValidateTODO,
+    [(u8)G_SETBLENDCOLOR] = gfxValidateTODO,
+    [(u8)G_SETFOGCOLOR] = gfxValidateTODO,
+    [(u8)G_SETFILLCOLOR] = gfxValidateTODO,
+    [(u8)G_FILLRECT] = gfxValidateRectCheap,
+    [(u8)G_SETTILE] = gfxValidateSetTileCheap,
+    [(u8)G_LOADTILE] = gfxValidateLoadTileCheap,
+    [(u8)G_LOADBLOCK] = gfxValidateLoadBlockCheap,
+    [(u8)G_SETTILESIZE] = gfxValidateSetTileSizeCheap,
+    [(u8)G_LOADTLUT] = gfxValidateLoadTLUTCheap,
+    [(u8)G_RDPSETOTHERMODE] = gfxValidateRDPSetOtherModeCheap,
+    [(u8)G_SETPRIMDEPTH] = gfxValidateSetPrimDepth,
+    [(u8)G_SETSCISSOR] = gfxValidateSetScissor,
+    [(u8)G_SETCONVERT] = gfxValidateTODO,
+    [(u8)G_SETKEYR] = gfxValidateTODO,
+    [(u8)G_SETKEYGB] = gfxValidateTODO,
+    [(u8)G_RDPFULLSYNC] = gfxValidateTODO,
+    [(u8)G_RDPTILESYNC] = gfxValidateTODO,
+    [(u8)G_RDPPIPESYNC] = gfxValidateTODO,
+    [(u8)G_RDPLOADSYNC] = gfxValidateTODO,
+    [(u8)G_TEXRECTFLIP] = gfxValidateRectCheap,
+    [(u8)G_TEXRECT] = gfxValidateRectCheap,
+};
+
+#ifndef GFX_DISABLE_STANDARD_VALIDATION
+// everything but TMEM and vertex buffer contents
+const GFXCommandValidator GFX_UCODE(gfxStandardValidators)[GFX_MAX_COMMAND_LEN] = {
+    [G_SPNOOP] = gfxValidateNoop,
+    [G_MTX] = gfxValidateMtx,
+    [G_MOVEMEM] = gfxValidateMoveMem,
+    [G_VTX] = gfxValidateVertexStandard,
+    [G_DL] = gfxValidateDL,
+#ifdef G_SPRITE2D_BASE
+    [G_SPRITE2D_BASE] = gfxValidateSprite2DBase,
+#endif
+
+    [(u8)G_TRI1] = gfxValidateTri1Standard,
+#ifdef G_TRI2
+    [(u8)G_TRI2] = gfxValidateTri2Standard,
+#endif
+    [(u8)G_CULLDL] = gfxValidateCullDLCheap,
+    [(u8)G_POPMTX] = gfxValidatePopMtx,
+    [(u8)G_MOVEWORD] = gfxValidateMoveWordCheap,
+    [(u8)G_TEXTURE] = gfxValidateTexture,
+    [(u8)G_SETOTHERMODE_H] = gfxValidateSetOtherModeH,
+    [(u8)G_SETOTHERMODE_L] = gfxValidateSetOtherModeL,
+    [(u8)G_ENDDL] = gfxValidateTODO,
+    [(u8)G_LINE3D] = gfxValidateLine3DStandard,
+    [(u8)G_RDPHALF_1] = gfxValidateRDPHalf1,
+    [(u8)G_RDPHALF_2] = gfxValidateTODO,
+#ifdef F3DEX_GBI_2
+    [(u8)G_MODIFYVTX] = gfxValidateModifyVertexCheap,
+    [(u8)G_BRANCH_Z] = gfxValidateBranchZCheap,
+    [(u8)G_QUAD] = gfxValidateTri2Standard,
+    [(u8)G_SPECIAL_1] = gfxValidateTODO,
+    [(u8)G_SPECIAL_2] = gfxValidateTODO,
+    [(u8)G_SPECIAL_3] = gfxValidateTODO,
+    [(u8)G_DMA_IO] = gfxValidateTODO,
+    [(u8)G_LOAD_UCODE] = gfxValidateTODO,
+    [(u8)G_GEOMETRYMODE] = gfxValidateGeometryMode,
+#else
+    [(u8)G_SETGEOMETRYMODE] = gfxValidateSetGeometryMode,
+    [(u8)G_CLEARGEOMETRYMODE] = gfxValidateClearGeometryMode,
+    [(u8)G_RDPHALF_CONT] = gfxValidateTODO,
+#endif
+
+    [(u8)G_NOOP] = gfxValidateRDPNoop,
+
+    [(u8)G_SETCIMG] = gfxValidateSetColorImage,
+    [(u8)G_SETZIMG] = gfxValidateSetDepthImage,
+    [(u8)G_SETTIMG] = gfxValidateSetTextureImage,
+    [(u8)G_SETCOMBINE] = gfxValidateRDPAttribute,
+    [(u8)G_SETENVCOLOR] = gfxValidateRDPAttribute,
+    [(u8)G_SETPRIMCOLOR] = gfxValidateTODO,
+    [(u8)G_SETBLENDCOLOR] = gfxValidateRDPAttribute,
+    [(u8)G_SETFOGCOLOR] = gfxValidateRDPAttribute,
+    [(u8)G_SETFILLCOLOR] = gfxValidateRDPAttribute,
+    [(u8)G_FILLRECT] = gfxValidateFillRect,
+    [(u8)G_SETTILE] = gfxValidateSetTile,
+    [(u8)G_LOADTILE] = gfxValidateLoadTileStandard,
+    [(u8)G_LOADBLOCK] = gfxValidateLoadBlockStandard,
+    [(u8)G_SETTILESIZE] = gfxValidateSetTileSizeStandard,
+    [(u8)G_LOADTLUT] = gfxValidateLoadTLUTStandard,
+    [(u8)G_RDPSETOTHERMODE] = gfxValidateRDPSetOtherMode,
+    [(u8)G_SETPRIMDEPTH] = gfxValidateSetPrimDepth,
+    [(u8)G_SETSCISSOR] = gfxValidateSetScissor,
+    [(u8)G_SETCONVERT] = gfxValidateRDPAttribute,
+    [(u8)G_SETKEYR] = gfxValidateRDPAttribute,
+    [(u8)G_SETKEYGB] = gfxValidateRDPAttribute,
+    [(u8)G_RDPFULLSYNC] = gfxValidateFullSync,
+    [(u8)G_RDPTILESYNC] = gfxValidateTileSync,
+    [(u8)G_RDPPIPESYNC] = gfxValidatePipeSync,
+    [(u8)G_RDPLOADSYNC] = gfxValidateLoadSync,
+    [(u8)G_TEXRECTFLIP] = gfxValidateTextureRect,
+    [(u8)G_TEXRECT] = gfxValidateTextureRect,
+};
+#endif
+
+#ifndef GFX_DISABLE_EXHAUSTIVE_VALIDATION
+// every check
+const GFXCommandValidator GFX_UCODE(gfxExhaustiveValidators)[GFX_MAX_COMMAND_LEN] = {
+    [G_SPNOOP] = gfxValidateNoop,
+    [G_MTX] = gfxValidateMtx,
+    [G_MOVEMEM] = gfxValidateMoveMem,
+    [G_VTX] = gfxValidateVertexStandard,
+    [G_DL] = gfxValidateDL,
+#ifdef G_SPRITE2D_BASE
+    [G_SPRITE2D_BASE] = gfxValidateSprite2DBase,
+#endif
+
+    [(u8)G_TRI1] = gfxValidateTri1,
+#ifdef G_TRI2
+    [(u8)G_TRI2] = gfxValidateTri2,
+#endif
+    [(u8)G_CULLDL] = gfxValidateCullDL,
+    [(u8)G_POPMTX] = gfxValidatePopMtx,
+#ifdef F3DEX_GBI_2
+    [(u8)G_MOVEWORD] = gfxValidateMoveWordCheap,
+#else
+    [(u8)G_MOVEWORD] = gfxValidateMoveWord,
+#endif
+    [(u8)G_TEXTURE] = gfxValidateTexture,
+    [(u8)G_SETOTHERMODE_H] = gfxValidateSetOtherModeH,
+    [(u8)G_SETOTHERMODE_L] = gfxValidateSetOtherModeL,
+    [(u8)G_ENDDL] = gfxValidateTODO,
+    [(u8)G_LINE3D] = gfxValidateLine3D,
+    [(u8)G_RDPHALF_1] = gfxValidateRDPHalf1,
+    [(u8)G_RDPHALF_2] = gfxValidateTODO,
+#ifdef F3DEX_GBI_2
+    [(u8)G_MODIFYVTX] = gfxValidateModifyVertex,
+    [(u8)G_BRANCH_Z] = gfxValidateBranchZ,
+    [(u8)G_QUAD] = gfxValidateTri2,
+    [(u8)G_SPECIAL_1] = gfxValidateTODO,
+    [(u8)G_SPECIAL_2] = gfxValidateTODO,
+    [(u8)G_SPECIAL_3] = gfxValidateTODO,
+    [(u8)G_DMA_IO] = gfxValidateTODO,
+    [(u8)G_LOAD_UCODE] = gfxValidateTODO,
+    [(u8)G_GEOMETRYMODE] = gfxValidateGeometryMode,
+#else
+    [(u8)G_SETGEOMETRYMODE] = gfxValidateSetGeometryMode,
+    [(u8)G_CLEARGEOMETRYMODE] = gfxValidateClearGeometryMode,
+    [(u8)G_RDPHALF_CONT] = gfxValidateTODO,
+#endif
+
+    [(u8)G_NOOP] = gfxValidateRDPNoop,
+
+    [(u8)G_SETCIMG] = gfxValidateSetColorImage,
+    [(u8)G_SETZIMG] = gfxValidateSetDepthImage,
+    [(u8)G_SETTIMG] = gfxValidateSetTextureImage,
+    [(u8)G_SETCOMBINE] = gfxValidateRDPAttribute,
+    [(u8)G_SETENVCOLOR] = gfxValidateRDPAttribute,
+    [(u8)G_SETPRIMCOLOR] = gfxValidateTODO,
+    [(u8)G_SETBLENDCOLOR] = gfxValidateRDPAttribute,
+    [(u8)G_SETFOGCOLOR] = gfxValidateRDPAttribute,
+    [(u8)G_SETFILLCOLOR] = gfxValidateRDPAttribute,
+    [(u8)G_FILLRECT] = gfxValidateFillRect,
+    [(u8)G_SETTILE] = gfxValidateSetTile,
+    [(u8)G_LOADTILE] = gfxValidateLoadTile,
+    [(u8)G_LOADBLOCK] = gfxValidateLoadBlock,
+    [(u8)G_SETTILESIZE] = gfxValidateSetTileSize,
+    [(u8)G_LOADTLUT] = gfxValidateLoadTLUT,
+    [(u8)G_RDPSETOTHERMODE] = gfxValidateRDPSetOtherMode,
+    [(u8)G_SETPRIMDEPTH] = gfxValidateSetPrimDepth,
+    [(u8)G_SETSCISSOR] = gfxValidateSetScissor,
+    [(u8)G_SETCONVERT] = gfxValidateRDPAttribute,
+    [(u8)G_SETKEYR] = gfxValidateRDPAttribute,
+    [(u8)G_SETKEYGB] = gfxValidateRDPAttribute,
+    [(u8)G_RDPFULLSYNC] = gfxValidateFullSync,
+    [(u8)G_RDPTILESYNC] = gfxValidateTileSync,
+    [(u8)G_RDPPIPESYNC] = gfxValidatePipeSync,
+    [(u8)G_RDPLOADSYNC] = gfxValidateLoadSync,
+    [(u8)G_TEXRECTFLIP] = gfxValidateTextureRect,
+    [(u8)G_TEXRECT] = gfxValidateTextureRect,
+};
+#endif
+
+const struct GFXMicrocode GFX_UCODE(gfxMicrocode) = {
+#ifdef F3DEX_GBI_2
+    .id = GFXMicrocodeF3DEX2,
+    .name = "F3DEX2",
+    .mergeTriangles = gfxMergeTriangles,
+#else
+    .id = GFXMicrocodeF3D,
+    .name = "F3D",
+#endif
+    .vertexBufferSize = VERTEX_BUFFER_SIZE,
+    .vertexIndexScale = VERTEX_INDEX_SCALE,
+    .vertexRange = gfxDecodeVertexRange,
+    .otherModeRange = gfxDecodeOtherModeRange,
+    .moveWordTarget = gfxDecodeMoveWordTarget,
+    .numLights = gfxDecodeNumLights,
+    .matrixFlags = gfxDecodeMatrixFlags,
+    .popCount = gfxDecodePopCount,
+    .matrixMove = gfxDecodeMatrixMove,
+    .triangles = gfxDecodeTriangles,
+    .validators = {
+        [GFXValidationCheap] = GFX_UCODE(gfxCheapValidators),
+#ifdef GFX_DISABLE_STANDARD_VALIDATION
+        [GFXValidationStandard] = GFX_UCODE(gfxCheapValidators),
+        [GFXValidationExhaustive] = GFX_UCODE(gfxCheapValidators),
+#elif defined(GFX_DISABLE_EXHAUSTIVE_VALIDATION)
+        [GFXValidationStandard] = GFX_UCODE(gfxStandardValidators),
+        [GFXValidationExhaustive] = GFX_UCODE(gfxStandardValidators),
+#else
+        [GFXValidationStandard] = GFX_UCODE(gfxStandardValidators),
+        [GFXValidationExhaustive] = GFX_UCODE(gfxExhaustiveValidators),
+#endif
+    },
+    .commands = {
+        [G_SPNOOP] = {"G_SPNOOP", GFXCommandSPNoop, gfxNoopCommandPrinter},
+        [G_MTX] = {"G_MTX", GFXCommandMtx, gfxMtxCommandPrinter},
+        [G_MOVEMEM] = {"G_MOVEMEM", GFXCommandMoveMem, gfxMoveMemCommandPrinter},
+        [G_VTX] = {"G_VTX", GFXCommandVertex, gfxVtxCommandPrinter},
+        [G_DL] = {"G_DL", GFXCommandDL, gfxDLCommandPrinter},
+#ifdef G_SPRITE2D_BASE
+        [G_SPRITE2D_BASE] = {"G_SPRITE2D_BASE", GFXCommandSprite2DBase, 0},
+#endif
+
+        [(u8)G_TRI1] = {"G_TRI1", GFXCommandTri1, gfxTri1CommandPrinter},
+#ifdef G_TRI2
+        [(u8)G_TRI2] = {"G_TRI2", GFXCommandTri2, gfxTri2CommandPrinter},
+#endif
+        [(u8)G_CULLDL] = {"G_CULLDL", GFXCommandCullDL, gfxCullDLCommandPrinter},
+        [(u8)G_POPMTX] = {"G_POPMTX", GFXCommandPopMtx, gfxPopMtxCommandPrinter},
+        [(u8)G_MOVEWORD] = {"G_MOVEWORD", GFXCommandMoveWord, gfxMoveWordCommandPrinter},
+        [(u8)G_TEXTURE] = {"G_TEXTURE", GFXCommandTexture, gfxTextureCommandPrinter},
+        [(u8)G_SETOTHERMODE_H] = {"G_SETOTHERMODE_H", GFXCommandSetOtherModeH, gfxSetOtherModeCommandPrinter},
+        [(u8)G_SETOTHERMODE_L] = {"G_SETOTHERMODE_L", GFXCommandSetOtherModeL, gfxSetOtherModeCommandPrinter},
+        [(u8)G_ENDDL] = {"G_ENDDL", GFXCommandEndDL, gfxEndDLCommandPrinter},
+        [(u8)G_LINE3D] = {"G_LINE3D", GFXCommandLine3D, gfxLine3DCommandPrinter},
+        [(u8)G_RDPHALF_1] = {"G_RDPHALF_1", GFXCommandRDPHalf1, gfxRDPHalf1CommandPrinter},
+        [(u8)G_RDPHALF_2] = {"G_RDPHALF_2", GFXCommandRDPHalf2, gfxRDPHalf2CommandPrinter},
+#ifdef F3DEX_GBI_2
+        [(u8)G_MODIFYVTX] = {"G_MODIFYVTX", GFXCommandModifyVertex, gfxModifyVertexCommandPrinter},
+        [(u8)G_BRANCH_Z] = {"G_BRANCH_Z", GFXCommandBranchZ, gfxBranchZCommandPrinter},
+        [(u8)G_QUAD] = {"G_QUAD", GFXCommandQuad, gfxQuadCommandPrinter},
+        [(u8)G_SPECIAL_1] = {"G_SPECIAL_1", GFXCommandSpecial, gfxSpecialCommandPrinter},
+        [(u8)G_SPECIAL_2] = {"G_SPECIAL_2", GFXCommandSpecial, gfxSpecialCommandPrinter},
+        [(u8)G_SPECIAL_3] = {"G_SPECIAL_3", GFXCommandSpecial, gfxSpecialCommandPrinter},
+        [(u8)G_DMA_IO] = {"G_DMA_IO", GFXCommandDmaIO, gfxDmaIOCommandPrinter},
+        [(u8)G_LOAD_UCODE] = {"G_LOAD_UCODE", GFXCommandLoadUcode, gfxLoadUcodeCommandPrinter},
+        [(u8)G_GEOMETRYMODE] = {"G_GEOMETRYMODE", GFXCommandGeometryMode, gfxGeometryModeCommandPrinter},
+#else
+        [(u8)G_SETGEOMETRYMODE] = {"G_SETGEOMETRYMODE", GFXCommandSetGeometryMode, gfxSetGeometryModeCommandPrinter},
+        [(u8)G_CLEARGEOMETRYMODE] = {"G_CLEARGEOMETRYMODE", GFXCommandClearGeometryMode, gfxClearGeometryModeCommandPrinter},
+        [(u8)G_RDPHALF_CONT] = {"G_RDPHALF_CONT", GFXCommandRDPHalfCont, 0},
+#endif
+
+        [(u8)G_NOOP] = {"G_NOOP", GFXCommandRDP, gfxRDPNoopCommandPrinter},
+
+        [(u8)G_SETCIMG] = {"G_SETCIMG", GFXCommandRDP, gfxSetColorImageCommandPrinter},
+        [(u8)G_SETZIMG] = {"G_SETZIMG", GFXCommandRDP, gfxSetDepthImageCommandPrinter},
+        [(u8)G_SETTIMG] = {"G_SETTIMG", GFXCommandRDP, gfxSetTextureImageCommandPrinter},
+        [(u8)G_SETCOMBINE] = {"G_SETCOMBINE", GFXCommandRDP, gfxSetCombineCommandPrinter},
+        [(u8)G_SETENVCOLOR] = {"G_SETENVCOLOR", GFXCommandRDP, gfxSetColorCommandPrinter},
+        [(u8)G_SETPRIMCOLOR] = {"G_SETPRIMCOLOR", GFXCommandRDP, gfxSetPrimColorCommandPrinter},
+        [(u8)G_SETBLENDCOLOR] = {"G_SETBLENDCOLOR", GFXCommandRDP, gfxSetColorCommandPrinter},
+        [(u8)G_SETFOGCOLOR] = {"G_SETFOGCOLOR", GFXCommandRDP, gfxSetColorCommandPrinter},
+        [(u8)G_SETFILLCOLOR] = {"G_SETFILLCOLOR", GFXCommandRDP, gfxSetFillColorCommandPrinter},
+        [(u8)G_FILLRECT] = {"G_FILLRECT", GFXCommandRDP, gfxFillRectCommandPrinter},
+        [(u8)G_SETTILE] = {"G_SETTILE", GFXCommandRDP, gfxSetTileCommandPrinter},
+        [(u8)G_LOADTILE] = {"G_LOADTILE", GFXCommandRDP, gfxLoadTileCommandPrinter},
+        [(u8)G_LOADBLOCK] = {"G_LOADBLOCK", GFXCommandRDP, gfxLoadBlockCommandPrinter},
+        [(u8)G_SETTILESIZE] = {"G_SETTILESIZE", GFXCommandRDP, gfxSetTileSizeCommandPrinter},
+        [(u8)G_LOADTLUT] = {"G_LOADTLUT", GFXCommandRDP, gfxLoadTLUTCommandPrinter},
+        [(u8)G_RDPSETOTHERMODE] = {"G_RDPSETOTHERMODE", GFXCommandRDP, gfxRDPSetOtherModeCommandPrinter},
+        [(u8)G_SETPRIMDEPTH] = {"G_SETPRIMDEPTH", GFXCommandRDP, gfxSetPrimDepthCommandPrinter},
+        [(u8)G_SETSCISSOR] = {"G_SETSCISSOR", GFXCommandRDP, gfxSetScissorCommandPrinter},
+        [(u8)G_SETCONVERT] = {"G_SETCONVERT", GFXCommandRDP, gfxSetConvertCommandPrinter},
+        [(u8)G_SETKEYR] = {"G_SETKEYR", GFXCommandRDP, gfxSetKeyRCommandPrinter},
+        [(u8)G_SETKEYGB] = {"G_SETKEYGB", GFXCommandRDP, gfxSetKeyGBCommandPrinter},
+        [(u8)G_RDPFULLSYNC] = {"G_RDPFULLSYNC", GFXCommandRDP, gfxSyncCommandPrinter},
+        [(u8)G_RDPTILESYNC] = {"G_RDPTILESYNC", GFXCommandRDP, gfxSyncCommandPrinter},
+        [(u8)G_RDPPIPESYNC] = {"G_RDPPIPESYNC", GFXCommandRDP, gfxSyncCommandPrinter},
+        [(u8)G_RDPLOADSYNC] = {"G_RDPLOADSYNC", GFXCommandRDP, gfxSyncCommandPrinter},
+        [(u8)G_TEXRECTFLIP] = {"G_TEXRECTFLIP", GFXCommandRDP, gfxTextureRectCommandPrinter},
+        [(u8)G_TEXRECT] = {"G_TEXRECT", GFXCommandRDP, gfxTextureRectCommandPrinter},
+    },
+};
\ No newline at end of file
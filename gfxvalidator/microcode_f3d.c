@@ -0,0 +1,4 @@
+// F3D is always built, whatever GBI picks as the default microcode
+#undef F3DEX_GBI_2
+
+#include "microcode_commands.h"
\ No newline at end of file
@@ -0,0 +1,6 @@
+// F3DEX2 is always built, whatever GBI picks as the default microcode
+#ifndef F3DEX_GBI_2
+#define F3DEX_GBI_2
+#endif
+
+#include "microcode_commands.h"
\ No newline at end of file
@@ -0,0 +1,94 @@
+
+#include "reasons.h"
+
+const char* const gfxReasonFormats[GFXReasonCount] = {
+    [GFXReasonNone] = "",
+    [GFXReasonListNotInRAM] = "display list 0x%08x isn't in RAM",
+    [GFXReasonListStackOverflow] = "display list stack overflow",
+    [GFXReasonBranchLoop] = "branch to 0x%08x forms a loop",
+    [GFXReasonSegmentUninitialized] = "attempt to use segment 0x%x before it was initialized",
+    [GFXReasonAlignment] = "address 0x%08x must to aligned to %d bytes",
+    [GFXReasonAddressNotInRAM] = "address 0x%08x translates to 0x%08x which isn't in RAM",
+    [GFXReasonNoopNotZero] = "nop instruction should equal 0",
+    [GFXReasonMatrixMalformed] = "malformed matrix operation",
+    [GFXReasonMatrixFlags] = "invalid matrix flags",
+    [GFXReasonMatrixStackOverflow] = "matrix stack overflow",
+    [GFXReasonProjectionPush] = "cannot push a G_MTX_PROJECTION matrix",
+    [GFXReasonMatrixMultiplyUninitialized] = "cannot multiply, no existing matrix exists",
+    [GFXReasonLightOffset] = "invalid light offset %d",
+    [GFXReasonMoveMemTarget] = "unrecognized copy target",
+    [GFXReasonCopySize] = "malformed copy size",
+    [GFXReasonNoLightCount] = "G_LIGHTING is set but the number of lights was never set",
+    [GFXReasonNoAmbientLight] = "G_LIGHTING is set with %d lights but the ambient light wasn't loaded",
+    [GFXReasonLightNotLoaded] = "G_LIGHTING is set with %d lights but light %d wasn't loaded",
+    [GFXReasonNoLookAt] = "G_TEXTURE_GEN is set but the lookat wasn't loaded",
+    [GFXReasonNoVertices] = "must include at least one vertex",
+    [GFXReasonVertexBufferOverflow] = "vertex buffer overflow v0: %d n: %d",
+    [GFXReasonListLength] = "malformed length",
+    [GFXReasonListFlags] = "malformed flags",
+    [GFXReasonVertexNotLoaded] = "vertex %d was never loaded",
+    [GFXReasonVertexIndex] = "vertex index too large for vertex buffer",
+    [GFXReasonModifyVertexIndex] = "modified vertex %d is outside the vertex buffer",
+    [GFXReasonCullRange] = "invalid cull range %d to %d",
+    [GFXReasonMatrixStackUnderflow] = "matrix stack underflow",
+    [GFXReasonSegmentIndex] = "segment should be in the range [0, 15] got %d",
+    [GFXReasonSegmentAddress] = "invalid ram address for segment %08x",
+    [GFXReasonLightCount] = "invalid light count %d",
+    [GFXReasonOtherModeRange] = "othermode shift %d and length %d out of range",
+    [GFXReasonCommandLimit] = "display list exceeded the command limit",
+    [GFXReasonUnknownCommand] = "unrecongized command with id %08x",
+    [GFXReasonStreamUnterminated] = "display list stream ended before G_ENDDL",
+    [GFXReasonTaskNotInRAM] = "task 0x%08x isn't in RAM",
+    [GFXReasonCILoadOverlapsPalette] = "CI texture load at tmem 0x%x overlaps the palette half of TMEM",
+    [GFXReasonLoadOverflow] = "texture load at tmem 0x%x with %d words doesn't fit in TMEM",
+    [GFXReasonLoadOverwritesPalette] = "texture load at tmem 0x%x overwrites the palette",
+    [GFXReasonNoTextureImage] = "texture load before G_SETTIMG",
+    [GFXReasonLoadTileNotSet] = "texture load with tile %d before G_SETTILE",
+    [GFXReasonTextureFormat] = "invalid texture format %d",
+    [GFXReasonTileFormat] = "invalid tile format %d",
+    [GFXReasonTileSizeNotSet] = "G_SETTILESIZE on tile %d before G_SETTILE",
+    [GFXReasonTileNegative] = "tile %d has a negative size",
+    [GFXReasonTileNotLoaded] = "tile %d reads tmem 0x%x-0x%x which wasn't loaded",
+    [GFXReasonLoadBlockEmpty] = "load block with no texels",
+    [GFXReasonLoadTileNegative] = "load tile with a negative size",
+    [GFXReasonTileLineShort] = "tile %d line of %d words is too short for %d texels",
+    [GFXReasonPaletteLowerHalf] = "palette must be loaded into the upper half of TMEM got tmem 0x%x",
+    [GFXReasonPaletteOverflow] = "palette with %d entries at tmem 0x%x doesn't fit in TMEM",
+    [GFXReasonNoColorImage] = "drawing before G_SETCIMG",
+    [GFXReasonNoDepthImage] = "depth buffering enabled before G_SETZIMG",
+    [GFXReasonDepthOverlapsColor] = "depth buffer 0x%08x overlaps the color buffer 0x%08x",
+    [GFXReasonDepthPastRAM] = "depth buffer 0x%08x runs past the end of RAM",
+    [GFXReasonColorImage4Bit] = "color image can't be 4 bit",
+    [GFXReasonScissorNegative] = "scissor has a negative size",
+    [GFXReasonMissingPipeSync] = "missing G_RDPPIPESYNC between a primitive and a change to the state it used",
+    [GFXReasonMissingTileSync] = "missing G_RDPTILESYNC before changing tile %d after a primitive used it",
+    [GFXReasonMissingLoadSync] = "missing G_RDPLOADSYNC between a textured primitive and a load into TMEM",
+    [GFXReasonRedundantPipeSync] = "no primitive since the last G_RDPPIPESYNC",
+    [GFXReasonRedundantTileSync] = "no primitive since the last G_RDPTILESYNC",
+    [GFXReasonRedundantLoadSync] = "no textured primitive since the last G_RDPLOADSYNC",
+    [GFXReasonRedundantFullSync] = "no primitive since the last G_RDPFULLSYNC",
+    [GFXReasonScissorPastWidth] = "scissor x %d is past the color image width %d",
+    [GFXReasonScissorPastRAM] = "scissor y %d runs past the end of RAM",
+    [GFXReasonRectPastWidth] = "rectangle x %d is past the color image width %d",
+    [GFXReasonRectPastRAM] = "rectangle y %d runs past the end of RAM",
+    [GFXReasonRectNegative] = "rectangle has a negative size",
+    [GFXReasonRedundantState] = "command doesn't change the state",
+    [GFXReasonRedundantVertexLoad] = "vertices %d to %d already hold this data",
+    [GFXReasonRedundantTextureLoad] = "texture 0x%08x is already loaded at tmem 0x%x",
+    [GFXReasonOptimizeOutputFull] = "optimized display list doesn't fit in %d commands",
+    [GFXReasonAddressRangePastRAM] = "%d bytes at 0x%08x run past the end of RAM",
+    [GFXReasonAddressNotRegistered] = "address 0x%08x translates to 0x%08x which isn't in a registered region",
+    [GFXReasonAddressPastRegion] = "%d bytes at 0x%08x run past the end of the region at 0x%08x",
+    [GFXReasonVertexNotFinite] = "%d vertices have w of 0 and no screen position, the first is vertex %d",
+    [GFXReasonVertexOverflow] = "%d vertices overflow s15.16 clip coordinates, the first is vertex %d",
+    [GFXReasonVertexGuardBand] = "%d vertices are outside the clip guard band, the first is vertex %d",
+    [GFXReasonTriangleDegenerate] = "triangle %d %d %d has no area",
+    [GFXReasonTriangleOffscreen] = "triangle %d %d %d is entirely off screen",
+    [GFXReasonMatrixOverflow] = "matrix product overflows s15.16 at row %d column %d",
+    [GFXReasonMatrixSingular] = "modelview matrix %d on the stack is singular or too small to be precise",
+    [GFXReasonPerspNormMismatch] = "G_MW_PERSPNORM is 0x%04x but the projection needs about 0x%04x",
+    [GFXReasonBranchZNoAddress] = "G_BRANCH_Z without a G_RDPHALF_1 holding the display list to branch to",
+    [GFXReasonPrimDepthRange] = "primitive depth 0x%04x is past 0x7fff",
+    [GFXReasonNoScissor] = "depth buffering without a scissor, the rows drawn to the depth image aren't known",
+    [GFXReasonSpriteLength] = "G_SPRITE2D_BASE length %d and flags %d, expected a %d byte uSprite with no flags",
+};
\ No newline at end of file
@@ -0,0 +1,104 @@
+#ifndef _GFX_VALIDATOR_REASONS_H
+#define _GFX_VALIDATOR_REASONS_H
+
+// why a command failed validation, gfxReasonFormats has a printf style
+// format for each that takes the numeric arguments stored alongside it so
+// nothing has to be formatted until the result is printed
+enum GFXReason {
+    GFXReasonNone,
+    GFXReasonListNotInRAM,
+    GFXReasonListStackOverflow,
+    GFXReasonBranchLoop,
+    GFXReasonSegmentUninitialized,
+    GFXReasonAlignment,
+    GFXReasonAddressNotInRAM,
+    GFXReasonNoopNotZero,
+    GFXReasonMatrixMalformed,
+    GFXReasonMatrixFlags,
+    GFXReasonMatrixStackOverflow,
+    GFXReasonProjectionPush,
+    GFXReasonMatrixMultiplyUninitialized,
+    GFXReasonLightOffset,
+    GFXReasonMoveMemTarget,
+    GFXReasonCopySize,
+    GFXReasonNoLightCount,
+    GFXReasonNoAmbientLight,
+    GFXReasonLightNotLoaded,
+    GFXReasonNoLookAt,
+    GFXReasonNoVertices,
+    GFXReasonVertexBufferOverflow,
+    GFXReasonListLength,
+    GFXReasonListFlags,
+    GFXReasonVertexNotLoaded,
+    GFXReasonVertexIndex,
+    GFXReasonModifyVertexIndex,
+    GFXReasonCullRange,
+    GFXReasonMatrixStackUnderflow,
+    GFXReasonSegmentIndex,
+    GFXReasonSegmentAddress,
+    GFXReasonLightCount,
+    GFXReasonOtherModeRange,
+    GFXReasonCommandLimit,
+    GFXReasonUnknownCommand,
+    GFXReasonStreamUnterminated,
+    GFXReasonTaskNotInRAM,
+    GFXReasonCILoadOverlapsPalette,
+    GFXReasonLoadOverflow,
+    GFXReasonLoadOverwritesPalette,
+    GFXReasonNoTextureImage,
+    GFXReasonLoadTileNotSet,
+    GFXReasonTextureFormat,
+    GFXReasonTileFormat,
+    GFXReasonTileSizeNotSet,
+    GFXReasonTileNegative,
+    GFXReasonTileNotLoaded,
+    GFXReasonLoadBlockEmpty,
+    GFXReasonLoadTileNegative,
+    GFXReasonTileLineShort,
+    GFXReasonPaletteLowerHalf,
+    GFXReasonPaletteOverflow,
+    GFXReasonNoColorImage,
+    GFXReasonNoDepthImage,
+    GFXReasonDepthOverlapsColor,
+    GFXReasonDepthPastRAM,
+    GFXReasonColorImage4Bit,
+    GFXReasonScissorNegative,
+    GFXReasonMissingPipeSync,
+    GFXReasonMissingTileSync,
+    GFXReasonMissingLoadSync,
+    GFXReasonRedundantPipeSync,
+    GFXReasonRedundantTileSync,
+    GFXReasonRedundantLoadSync,
+    GFXReasonRedundantFullSync,
+    GFXReasonScissorPastWidth,
+    GFXReasonScissorPastRAM,
+    GFXReasonRectPastWidth,
+    GFXReasonRectPastRAM,
+    GFXReasonRectNegative,
+    GFXReasonRedundantState,
+    GFXReasonRedundantVertexLoad,
+    GFXReasonRedundantTextureLoad,
+    GFXReasonOptimizeOutputFull,
+    GFXReasonAddressRangePastRAM,
+    GFXReasonAddressNotRegistered,
+    GFXReasonAddressPastRegion,
+    GFXReasonVertexNotFinite,
+    GFXReasonVertexOverflow,
+    GFXReasonVertexGuardBand,
+    GFXReasonTriangleDegenerate,
+    GFXReasonTriangleOffscreen,
+    GFXReasonMatrixOverflow,
+    GFXReasonMatrixSingular,
+    GFXReasonPerspNormMismatch,
+    GFXReasonBranchZNoAddress,
+    GFXReasonPrimDepthRange,
+    GFXReasonNoScissor,
+    GFXReasonSpriteLength,
+    GFXReasonCount,
+};
+
+#define GFX_MAX_REASON_ARGS     3
+
+extern const char* const gfxReasonFormats[GFXReasonCount];
+
+#endif
\ No newline at end of file
@@ -0,0 +1,418 @@
+
+#include "redundancy.h"
+#include "validator_internal.h"
+#include "format.h"
+#include "gfx_macros.h"
+#include <string.h>
+
+#define REDUNDANCY_LINE_LENGTH  80
+
+// physical address of a segmented address if the segment is set
+u32 gfxShadowAddress(struct GFXValidatorState* state, u32 address) {
+    int segment = _SHIFTR(address, 24, 4);
+
+    if (state->pipeline.segments[segment] == SEGMENT_UNINITIALIZED) {
+        return address;
+    }
+
+    return state->pipeline.segments[segment] + (address & 0xFFFFFF);
+}
+
+int gfxShadowSlot(int commandType, int kind) {
+    if (kind == GFXCommandTexture) {
+        return GFXShadowTexture;
+    }
+
+    switch (commandType) {
+        case (u8)G_SETCOMBINE: return GFXShadowCombine;
+        case (u8)G_SETENVCOLOR: return GFXShadowEnvColor;
+        case (u8)G_SETPRIMCOLOR: return GFXShadowPrimColor;
+        case (u8)G_SETBLENDCOLOR: return GFXShadowBlendColor;
+        case (u8)G_SETFOGCOLOR: return GFXShadowFogColor;
+        case (u8)G_SETFILLCOLOR: return GFXShadowFillColor;
+        case (u8)G_SETPRIMDEPTH: return GFXShadowPrimDepth;
+        case (u8)G_SETSCISSOR: return GFXShadowScissor;
+        case (u8)G_SETCONVERT: return GFXShadowConvert;
+        case (u8)G_SETKEYR: return GFXShadowKeyR;
+        case (u8)G_SETKEYGB: return GFXShadowKeyGB;
+        case (u8)G_SETCIMG: return GFXShadowColorImage;
+        case (u8)G_SETZIMG: return GFXShadowDepthImage;
+        case (u8)G_SETTIMG: return GFXShadowTextureImage;
+    }
+
+    return -1;
+}
+
+int gfxSameCommand(Gfx* a, Gfx* b) {
+    return a->words.w0 == b->words.w0 && a->words.w1 == b->words.w1;
+}
+
+// copy of command with the address in w1 made physical
+void gfxShadowCommand(struct GFXValidatorState* state, Gfx* command, Gfx* output) {
+    output->words.w0 = command->words.w0;
+    output->words.w1 = GFX_WORD(gfxShadowAddress(state, GFX_W1(command)));
+}
+
+// sets the bits in mask to value, returns 1 if they were already known to
+// hold value
+int gfxShadowBits(u32* bits, u32* known, u32 mask, u32 value) {
+    int redundant = (*known & mask) == mask && (*bits & mask) == (value & mask);
+    *bits = (*bits & ~mask) | (value & mask);
+    *known |= mask;
+    return redundant;
+}
+
+// sets a tile descriptor or size, returns 1 if it already held command
+int gfxShadowTile(Gfx* tiles, u8* known, Gfx* command) {
+    int tile = _SHIFTR(GFX_W1(command), 24, 3);
+    int redundant = (*known & (1 << tile)) && gfxSameCommand(&tiles[tile], command);
+    tiles[tile] = *command;
+    *known |= 1 << tile;
+    return redundant;
+}
+
+// TMEM words a load into tile writes, 32 bit loads are split between both
+// halves of TMEM so they are treated as writing everything past the start
+void gfxLoadExtent(Gfx* command, struct GFXTile* tile, int* start, int* end) {
+    int words;
+    int uls = _SHIFTR(GFX_W0(command), 12, 12);
+    int ult = _SHIFTR(GFX_W0(command), 0, 12);
+    int lrs = _SHIFTR(GFX_W1(command), 12, 12);
+    int lrt = _SHIFTR(GFX_W1(command), 0, 12);
+
+    switch (GFX_COMMAND(command)) {
+        case (u8)G_LOADBLOCK:
+            words = ((((lrs - uls + 1) << tile->size) >> 1) + 7) >> 3;
+            break;
+        case (u8)G_LOADTILE:
+            words = tile->line * ((lrt >> 2) - (ult >> 2) + 1);
+            break;
+        default:
+            words = (lrs >> 2) - (uls >> 2) + 1;
+            break;
+    }
+
+    *start = tile->tmem;
+    *end = tile->tmem + (words > 0 ? words : 0);
+
+    if (tile->size == G_IM_SIZ_32b || *end > GFX_TMEM_WORDS) {
+        *end = GFX_TMEM_WORDS;
+    }
+}
+
+int gfxShadowLoad(struct GFXValidatorState* state, struct GFXShadowState* shadow, Gfx* command) {
+    struct GFXTile* tile = &state->pipeline.tiles[_SHIFTR(GFX_W1(command), 24, 3)];
+    struct GFXResidentLoad load;
+    int start;
+    int end;
+    int i;
+    int kept = 0;
+
+    if (!(shadow->knownCommands & (1 << GFXShadowTextureImage))) {
+        return 0;
+    }
+
+    // clear any padding so loads can be compared with memcmp
+    memset(&load, 0, sizeof(load));
+    load.textureImage = shadow->commands[GFXShadowTextureImage];
+    load.load = *command;
+    load.tile = *tile;
+    gfxLoadExtent(command, tile, &start, &end);
+    load.start = start;
+    load.end = end;
+
+    for (i = 0; i < shadow->residentLoadCount; ++i) {
+        if (memcmp(&shadow->residentLoads[i], &load, sizeof(load)) == 0) {
+            gfxWarn(state, GFXValidatorRedundantState, GFXReasonRedundantTextureLoad, GFX_W1(&load.textureImage), start);
+            return 1;
+        }
+    }
+
+    // forget loads this one overwrites
+    for (i = 0; i < shadow->residentLoadCount; ++i) {
+        struct GFXResidentLoad* resident = &shadow->residentLoads[i];
+
+        if (resident->end <= start || resident->start >= end) {
+            shadow->residentLoads[kept++] = *resident;
+        }
+    }
+
+    // drop the oldest when full
+    if (kept == GFX_RESIDENT_LOADS) {
+        memmove(&shadow->residentLoads[0], &shadow->residentLoads[1], sizeof(struct GFXResidentLoad) * (GFX_RESIDENT_LOADS - 1));
+        --kept;
+    }
+
+    shadow->residentLoads[kept++] = load;
+    shadow->residentLoadCount = kept;
+
+    return 0;
+}
+
+int gfxShadowVertexLoad(struct GFXValidatorState* state, struct GFXShadowState* shadow, Gfx* command) {
+    Gfx load;
+    gfxShadowCommand(state, command, &load);
+
+    if (shadow->vertexLoadValid && gfxSameCommand(&shadow->vertexLoad, &load)) {
+        int count;
+        int v0;
+        state->microcode->vertexRange(command, &v0, &count);
+        gfxWarn(state, GFXValidatorRedundantState, GFXReasonRedundantVertexLoad, v0, v0 + count - 1);
+        return 1;
+    }
+
+    shadow->vertexLoad = load;
+    shadow->vertexLoadValid = 1;
+    return 0;
+}
+
+// returns 1 if command doesn't change the state and updates the shadow
+// state otherwise
+int gfxShadowUpdate(struct GFXValidatorState* state, struct GFXShadowState* shadow, Gfx* command) {
+    int commandType = GFX_COMMAND(command);
+    int kind = GFX_COMMAND_KIND(state->microcode, command);
+    int slot = gfxShadowSlot(commandType, kind);
+    int redundant = 0;
+    int shift;
+    int length;
+
+    if (slot >= 0) {
+        Gfx value = *command;
+
+        if (slot >= GFXShadowColorImage) {
+            gfxShadowCommand(state, command, &value);
+        }
+
+        redundant = (shadow->knownCommands & (1 << slot)) && gfxSameCommand(&shadow->commands[slot], &value);
+        shadow->commands[slot] = value;
+        shadow->knownCommands |= 1 << slot;
+
+        // texture scaling is applied as vertices are loaded
+        if (kind == GFXCommandTexture) {
+            shadow->vertexLoadValid &= redundant;
+        }
+    } else {
+        switch (kind) {
+            case GFXCommandSetOtherModeH:
+                state->microcode->otherModeRange(command, &shift, &length);
+                redundant = gfxShadowBits(
+                    &shadow->othermodeH,
+                    &shadow->knownOthermodeH,
+                    (u32)(((1ull << length) - 1) << shift),
+                    GFX_W1(command)
+                );
+                break;
+            case GFXCommandSetOtherModeL:
+                state->microcode->otherModeRange(command, &shift, &length);
+                redundant = gfxShadowBits(
+                    &shadow->othermodeL,
+                    &shadow->knownOthermodeL,
+                    (u32)(((1ull << length) - 1) << shift),
+                    GFX_W1(command)
+                );
+                break;
+            case GFXCommandGeometryMode:
+                {
+                    u32 clear = ~GFX_W0(command) & 0x00FFFFFF;
+                    u32 set = GFX_W1(command);
+                    u32 value = ((shadow->geometryMode & ~clear) | set);
+                    redundant = gfxShadowBits(&shadow->geometryMode, &shadow->knownGeometryMode, clear | set, value);
+                    shadow->vertexLoadValid &= redundant;
+                }
+                break;
+            case GFXCommandSetGeometryMode:
+                redundant = gfxShadowBits(&shadow->geometryMode, &shadow->knownGeometryMode, GFX_W1(command), 0xFFFFFFFF);
+                shadow->vertexLoadValid &= redundant;
+                break;
+            case GFXCommandClearGeometryMode:
+                redundant = gfxShadowBits(&shadow->geometryMode, &shadow->knownGeometryMode, GFX_W1(command), 0);
+                shadow->vertexLoadValid &= redundant;
+                break;
+            case GFXCommandVertex:
+                return gfxShadowVertexLoad(state, shadow, command);
+            case GFXCommandMoveWord:
+                {
+                    int index;
+                    int offset;
+                    u32 data = GFX_W1(command);
+                    state->microcode->moveWordTarget(command, &index, &offset);
+
+                    if (index == G_MW_SEGMENT) {
+                        redundant = (offset >> 2) < GFX_MAX_SEGMENTS && state->pipeline.segments[offset >> 2] == (int)data;
+                    } else if (index == G_MW_NUMLIGHT) {
+                        redundant = (state->pipeline.flags & GFX_INITIALIZED_NUMLIGHT) && state->pipeline.numLights == state->microcode->numLights(data);
+                    }
+
+                    if (!redundant && index != G_MW_SEGMENT) {
+                        shadow->vertexLoadValid = 0;
+                    }
+                }
+                break;
+            case GFXCommandMtx:
+            case GFXCommandMoveMem:
+            case GFXCommandPopMtx:
+            case GFXCommandModifyVertex:
+                shadow->vertexLoadValid = 0;
+                break;
+        }
+
+        switch (commandType) {
+            case (u8)G_RDPSETOTHERMODE:
+                // only redundant if both words are
+                redundant = gfxShadowBits(&shadow->othermodeH, &shadow->knownOthermodeH, 0x00FFFFFF, GFX_W0(command));
+                redundant = gfxShadowBits(&shadow->othermodeL, &shadow->knownOthermodeL, 0xFFFFFFFF, GFX_W1(command)) && redundant;
+                break;
+            case (u8)G_SETTILE:
+                redundant = gfxShadowTile(shadow->tiles, &shadow->knownTiles, command);
+                break;
+            case (u8)G_SETTILESIZE:
+                redundant = gfxShadowTile(shadow->tileSizes, &shadow->knownTileSizes, command);
+                break;
+            case (u8)G_LOADBLOCK:
+            case (u8)G_LOADTILE:
+            case (u8)G_LOADTLUT:
+                // reports its own warning
+                return gfxShadowLoad(state, shadow, command);
+        }
+    }
+
+    if (redundant) {
+        gfxWarn(state, GFXValidatorRedundantState, GFXReasonRedundantState);
+    }
+
+    return redundant;
+}
+
+struct GFXRedundancySite* gfxFindRedundancySite(struct GFXRedundancyReport* report, u32 listAddress) {
+    u32 mask = report->capacity - 1;
+    u32 slot = ((listAddress >> 3) * 2654435761u) & mask;
+
+    if (!report->capacity) {
+        return 0;
+    }
+
+    while (report->sites[slot].listAddress) {
+        if (report->sites[slot].listAddress == listAddress) {
+            return &report->sites[slot];
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    // keep a free slot so the search above always ends
+    if (report->siteCount + 1 >= report->capacity) {
+        return 0;
+    }
+
+    ++report->siteCount;
+    report->sites[slot].listAddress = listAddress;
+    return &report->sites[slot];
+}
+
+void gfxRedundancyVisitor(void* data, struct GFXValidatorState* state, Gfx* command) {
+    struct GFXRedundancyReport* report = (struct GFXRedundancyReport*)data;
+    int depth = state->gfxStackSize - 1;
+    u32 listAddress = state->gfxStack[depth].startAddress;
+
+    if (report->stackAddresses[depth] != listAddress) {
+        report->stackAddresses[depth] = listAddress;
+        report->stackSites[depth] = gfxFindRedundancySite(report, listAddress);
+    }
+
+    struct GFXRedundancySite* site = report->stackSites[depth];
+
+    ++report->commands;
+
+    if (site) {
+        ++site->commands;
+    }
+
+    if (gfxShadowUpdate(state, &report->shadow, command)) {
+        ++report->redundantCommands;
+        ++report->redundantByCommand[GFX_COMMAND(command)];
+
+        if (site) {
+            ++site->redundantCommands;
+        } else {
+            ++report->untrackedCommands;
+        }
+    }
+}
+
+void gfxRedundancyReportInit(struct GFXRedundancyReport* report, struct GFXRedundancySite* sites, u32 capacity) {
+    memset(report, 0, sizeof(struct GFXRedundancyReport));
+    memset(sites, 0, sizeof(struct GFXRedundancySite) * capacity);
+    report->sites = sites;
+    report->capacity = capacity;
+}
+
+enum GFXValidatorError gfxFindRedundantState(u32 address, int maxGfxCount, struct GFXValidatorOptions* options, struct GFXRedundancyReport* report, struct GFXValidationResult* result) {
+    struct GFXValidatorOptions redundancyOptions = *options;
+    int i;
+
+    memset(&report->shadow, 0, sizeof(report->shadow));
+
+    for (i = 0; i < GFX_MAX_GFX_STACK; ++i) {
+        // no display list starts at 0 so the site is looked up again
+        report->stackAddresses[i] = 0;
+    }
+
+    // every command has to be seen so nothing can be skipped by the cache
+    redundancyOptions.cache = 0;
+    redundancyOptions.visitor = gfxRedundancyVisitor;
+    redundancyOptions.visitorData = report;
+
+    return gfxValidateDisplayList(address, maxGfxCount, &redundancyOptions, result);
+}
+
+void gfxPrintRedundancyReport(struct GFXRedundancyReport* report, int maxSites, gfxPrinter printer) {
+    char line[REDUNDANCY_LINE_LENGTH];
+    u32 count = 0;
+    u32 i;
+    u32 j;
+
+    printer(line, gfxFormat(
+        line,
+        REDUNDANCY_LINE_LENGTH,
+        "%u of %u commands are redundant\n",
+        report->redundantCommands,
+        report->commands
+    ));
+
+    for (i = 0; i < GFX_MAX_COMMAND_LEN; ++i) {
+        if (report->redundantByCommand[i]) {
+            printer(line, gfxFormat(line, REDUNDANCY_LINE_LENGTH, "  0x%02x %u\n", i, report->redundantByCommand[i]));
+        }
+    }
+
+    // move the sites with redundant commands to the front, most first
+    for (i = 0; i < report->capacity; ++i) {
+        struct GFXRedundancySite site = report->sites[i];
+
+        if (!site.listAddress || !site.redundantCommands) {
+            continue;
+        }
+
+        for (j = count; j > 0 && report->sites[j - 1].redundantCommands < site.redundantCommands; --j) {
+            report->sites[j] = report->sites[j - 1];
+        }
+
+        report->sites[j] = site;
+        ++count;
+    }
+
+    for (i = 0; i < count && (int)i < maxSites; ++i) {
+        printer(line, gfxFormat(
+            line,
+            REDUNDANCY_LINE_LENGTH,
+            "0x%08x: %u of %u redundant\n",
+            report->sites[i].listAddress,
+            report->sites[i].redundantCommands,
+            report->sites[i].commands
+        ));
+    }
+
+    if (report->untrackedCommands) {
+        printer(line, gfxFormat(line, REDUNDANCY_LINE_LENGTH, "%u in display lists not tracked\n", report->untrackedCommands));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#ifndef _GFX_VALIDATOR_REDUNDANCY_H
+#define _GFX_VALIDATOR_REDUNDANCY_H
+
+#include "validator.h"
+
+// texture loads remembered as resident in TMEM
+#define GFX_RESIDENT_LOADS      8
+
+// commands that replace a piece of state as a whole, see gfxShadowSlot
+enum GFXShadowSlot {
+    GFXShadowCombine,
+    GFXShadowEnvColor,
+    GFXShadowPrimColor,
+    GFXShadowBlendColor,
+    GFXShadowFogColor,
+    GFXShadowFillColor,
+    GFXShadowPrimDepth,
+    GFXShadowScissor,
+    GFXShadowConvert,
+    GFXShadowKeyR,
+    GFXShadowKeyGB,
+    GFXShadowTexture,
+    // commands from here on hold an address in w1
+    GFXShadowColorImage,
+    GFXShadowDepthImage,
+    GFXShadowTextureImage,
+    GFXShadowCount,
+};
+
+struct GFXRedundancySite {
+    // physical address the display list starts at, 0 for an empty slot
+    u32 listAddress;
+    u32 commands;
+    u32 redundantCommands;
+};
+
+struct GFXResidentLoad {
+    // the G_SETTIMG and load command with physical addresses
+    Gfx textureImage;
+    Gfx load;
+    // the load tile
+    struct GFXTile tile;
+    // TMEM words written
+    u16 start;
+    u16 end;
+};
+
+// the state set by the display list so far, bits in the known masks are set
+// once a command has set that part of the state
+struct GFXShadowState {
+    Gfx commands[GFXShadowCount];
+    u32 knownCommands;
+    u32 othermodeH;
+    u32 othermodeL;
+    u32 knownOthermodeH;
+    u32 knownOthermodeL;
+    u32 geometryMode;
+    u32 knownGeometryMode;
+    Gfx tiles[GFX_MAX_TILES];
+    Gfx tileSizes[GFX_MAX_TILES];
+    u8 knownTiles;
+    u8 knownTileSizes;
+    // vertices are transformed when they are loaded so this is forgotten
+    // whenever the matrices, lights or anything else used by the transform
+    // changes
+    Gfx vertexLoad;
+    u8 vertexLoadValid;
+    u8 residentLoadCount;
+    struct GFXResidentLoad residentLoads[GFX_RESIDENT_LOADS];
+};
+
+struct GFXRedundancyReport {
+    // open addressed on listAddress, capacity must be a power of 2
+    struct GFXRedundancySite* sites;
+    u32 capacity;
+    u32 siteCount;
+    u32 commands;
+    u32 redundantCommands;
+    u32 redundantByCommand[GFX_MAX_COMMAND_LEN];
+    // redundant commands in display lists that didn't fit in sites
+    u32 untrackedCommands;
+    // site of each display list on the stack, looked up when it changes
+    struct GFXRedundancySite* stackSites[GFX_MAX_GFX_STACK];
+    u32 stackAddresses[GFX_MAX_GFX_STACK];
+    struct GFXShadowState shadow;
+};
+
+// updates shadow with the command about to run in state, returns 1 and
+// reports a warning if it doesn't change anything. a zeroed shadow knows
+// nothing about the state
+int gfxShadowUpdate(struct GFXValidatorState* state, struct GFXShadowState* shadow, Gfx* command);
+
+void gfxRedundancyReportInit(struct GFXRedundancyReport* report, struct GFXRedundancySite* sites, u32 capacity);
+
+// validates the display list at address while looking for commands that
+// leave the state as it was, each one is reported as a
+// GFXValidatorRedundantState warning to options.onWarning and
+// options.diagnostics and counted in report. counts add up over calls, the
+// state set by earlier calls is not remembered. options.visitor and
+// options.cache are ignored
+enum GFXValidatorError gfxFindRedundantState(u32 address, int maxGfxCount, struct GFXValidatorOptions* options, struct GFXRedundancyReport* report, struct GFXValidationResult* result);
+
+// prints the totals, the redundant commands by opcode and the maxSites
+// display lists with the most redundant commands. sorts report->sites so
+// the report has to be initialized again before it is reused
+void gfxPrintRedundancyReport(struct GFXRedundancyReport* report, int maxSites, gfxPrinter printer);
+
+#endif
\ No newline at end of file
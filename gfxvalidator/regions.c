@@ -0,0 +1,75 @@
+
+#include "regions.h"
+
+#include <string.h>
+
+#define REGION_ADDRESS(address)     ((address) & 0x1FFFFFFF)
+
+void gfxRegionIndexInit(struct GFXRegionIndex* index, struct GFXRegion* regions, u32 capacity) {
+    index->regions = regions;
+    index->count = 0;
+    index->capacity = capacity;
+}
+
+// number of regions that start at or before address
+u32 gfxRegionUpperBound(const struct GFXRegionIndex* index, u32 address) {
+    const struct GFXRegion* base = index->regions;
+    u32 count = index->count;
+
+    // halves the range each step without branching on the comparison
+    while (count > 1) {
+        u32 half = count >> 1;
+        base = base[half].start <= address ? base + half : base;
+        count -= half;
+    }
+
+    return (u32)(base - index->regions) + (count && base->start <= address);
+}
+
+int gfxRegionAdd(struct GFXRegionIndex* index, u32 address, u32 length, const char* tag) {
+    u32 start = REGION_ADDRESS(address);
+    u32 at;
+
+    if (index->count == index->capacity || length == 0 || length > 0x20000000 - start) {
+        return 0;
+    }
+
+    at = gfxRegionUpperBound(index, start);
+
+    if ((at > 0 && index->regions[at - 1].end > start) || (at < index->count && index->regions[at].start < start + length)) {
+        return 0;
+    }
+
+    memmove(&index->regions[at + 1], &index->regions[at], sizeof(struct GFXRegion) * (index->count - at));
+    index->regions[at].start = start;
+    index->regions[at].end = start + length;
+    index->regions[at].tag = tag;
+    ++index->count;
+
+    return 1;
+}
+
+int gfxRegionRemove(struct GFXRegionIndex* index, u32 address) {
+    u32 start = REGION_ADDRESS(address);
+    u32 at = gfxRegionUpperBound(index, start);
+
+    if (at == 0 || index->regions[at - 1].start != start) {
+        return 0;
+    }
+
+    --index->count;
+    memmove(&index->regions[at - 1], &index->regions[at], sizeof(struct GFXRegion) * (index->count - (at - 1)));
+
+    return 1;
+}
+
+const struct GFXRegion* gfxRegionFind(const struct GFXRegionIndex* index, u32 address) {
+    u32 start = REGION_ADDRESS(address);
+    u32 at = gfxRegionUpperBound(index, start);
+
+    if (at == 0 || index->regions[at - 1].end <= start) {
+        return 0;
+    }
+
+    return &index->regions[at - 1];
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef _GFX_VALIDATOR_REGIONS_H
+#define _GFX_VALIDATOR_REGIONS_H
+
+#include <ultra64.h>
+
+// a block of memory display lists are allowed to read from such as a vertex
+// pool or matrix arena
+struct GFXRegion {
+    // physical addresses, end is exclusive
+    u32 start;
+    u32 end;
+    // name shown when the region is printed, not copied
+    const char* tag;
+};
+
+// registered regions kept sorted by start in one array so a lookup is a
+// binary search over contiguous memory. regions never overlap
+struct GFXRegionIndex {
+    struct GFXRegion* regions;
+    u32 count;
+    u32 capacity;
+};
+
+void gfxRegionIndexInit(struct GFXRegionIndex* index, struct GFXRegion* regions, u32 capacity);
+
+// registers [address, address + length), address can be physical or in
+// KSEG0. returns 0 if the index is full, length is 0 or the region overlaps
+// one that is already registered
+int gfxRegionAdd(struct GFXRegionIndex* index, u32 address, u32 length, const char* tag);
+// removes the region starting at address, returns 0 if there isn't one.
+// display lists in a GFXValidationCache were checked against the regions
+// registered at the time so clear it after removing a region
+int gfxRegionRemove(struct GFXRegionIndex* index, u32 address);
+// the region containing address, 0 if there isn't one
+const struct GFXRegion* gfxRegionFind(const struct GFXRegionIndex* index, u32 address);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,38 @@
+
+#include "sampler.h"
+
+void gfxSamplerInit(struct GFXSampler* sampler, int framePeriod, int percent) {
+    sampler->framePeriod = framePeriod;
+    sampler->listPeriod = percent > 0 ? (100 + percent - 1) / percent : 0;
+    sampler->frame = 0;
+    sampler->lists = 0;
+    sampler->sampledLists = 0;
+}
+
+int gfxSamplerBeginFrame(struct GFXSampler* sampler) {
+    u32 frame = sampler->frame++;
+
+    sampler->lists = 0;
+    sampler->sampledLists = 0;
+
+    return sampler->framePeriod && frame % sampler->framePeriod == 0;
+}
+
+int gfxSamplerPickList(struct GFXSampler* sampler, u32 address) {
+    ++sampler->lists;
+
+    if (!sampler->listPeriod) {
+        return 0;
+    }
+
+    // the hash scatters which lists share a frame, adding the frame number
+    // moves each list to the front once every listPeriod frames
+    u32 hash = ((address >> 3) * 0x9E3779B1u) >> 16;
+
+    if ((hash + sampler->frame) % sampler->listPeriod != 0) {
+        return 0;
+    }
+
+    ++sampler->sampledLists;
+    return 1;
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef _GFX_VALIDATOR_SAMPLER_H
+#define _GFX_VALIDATOR_SAMPLER_H
+
+#include <ultra64.h>
+
+// spreads validation of a frame over several frames so it can stay on in a
+// shipping build. most frames are walked at GFXValidationCheap and only some
+// of the display lists pushed with G_DL are checked at
+// GFXValidatorOptions.level. which lists are picked rotates so every one is
+// checked within listPeriod frames
+struct GFXSampler {
+    // one frame in framePeriod is checked in full, 0 never does
+    u16 framePeriod;
+    // every pushed display list is checked at least once in this many
+    // frames, 0 only checks the full frames
+    u16 listPeriod;
+    // counts validations started with the sampler, each is one frame
+    u32 frame;
+    // pushed display lists seen and checked in full by the last frame, both
+    // are 0 after a full frame
+    u32 lists;
+    u32 sampledLists;
+};
+
+// percent of the pushed display lists to check in full on the other
+// frames, 0 to 100
+void gfxSamplerInit(struct GFXSampler* sampler, int framePeriod, int percent);
+
+// starts the next frame, returns 1 if it should be checked in full
+int gfxSamplerBeginFrame(struct GFXSampler* sampler);
+// returns 1 if the display list at the physical address should be checked
+// in full this frame
+int gfxSamplerPickList(struct GFXSampler* sampler, u32 address);
+
+#endif
\ No newline at end of file
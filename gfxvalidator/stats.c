@@ -0,0 +1,35 @@
+#include "stats.h"
+#include "format.h"
+#include <string.h>
+
+#define STATS_LINE_LENGTH   64
+
+void gfxFrameStatsClear(struct GFXFrameStats* stats) {
+    memset(stats, 0, sizeof(struct GFXFrameStats));
+}
+
+void gfxPrintFrameStats(struct GFXFrameStats* stats, gfxPrinter printer) {
+    char line[STATS_LINE_LENGTH];
+    int i;
+
+    printer(line, gfxFormat(line, STATS_LINE_LENGTH, "commands %u\n", stats->commands));
+    printer(line, gfxFormat(line, STATS_LINE_LENGTH, "triangles %u\n", stats->triangles));
+    printer(line, gfxFormat(line, STATS_LINE_LENGTH, "vertices %u\n", stats->verticesLoaded));
+    printer(line, gfxFormat(
+        line, 
+        STATS_LINE_LENGTH, 
+        "dma bytes vtx %u mtx %u movemem %u\n", 
+        stats->vertexBytes, 
+        stats->matrixBytes, 
+        stats->moveMemBytes
+    ));
+    printer(line, gfxFormat(line, STATS_LINE_LENGTH, "texture bytes %u\n", stats->textureBytes));
+    printer(line, gfxFormat(line, STATS_LINE_LENGTH, "matrix push %u pop %u\n", stats->matrixPushes, stats->matrixPops));
+    printer(line, gfxFormat(line, STATS_LINE_LENGTH, "max display list depth %u\n", stats->maxDisplayListDepth));
+
+    for (i = 0; i < GFX_MAX_COMMAND_LEN; ++i) {
+        if (stats->commandCounts[i]) {
+            printer(line, gfxFormat(line, STATS_LINE_LENGTH, "  0x%02x %u\n", i, stats->commandCounts[i]));
+        }
+    }
+}
\ No newline at end of file
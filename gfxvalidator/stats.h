@@ -0,0 +1,33 @@
+#ifndef _GFX_VALIDATOR_STATS_H
+#define _GFX_VALIDATOR_STATS_H
+
+#include "validator.h"
+
+// counters filled in while a display list is validated, pass one through
+// GFXValidatorOptions.stats. commands in display lists skipped by the
+// validation cache aren't counted. building with GFX_DISABLE_STATS removes
+// the counting from the validator and options.stats is ignored
+struct GFXFrameStats {
+    // commands validated by opcode
+    u32 commandCounts[GFX_MAX_COMMAND_LEN];
+    u32 commands;
+    // by G_TRI1, G_TRI2 and G_QUAD
+    u32 triangles;
+    u32 verticesLoaded;
+    // bytes the RSP copies for G_VTX, G_MTX and G_MOVEMEM
+    u32 vertexBytes;
+    u32 matrixBytes;
+    u32 moveMemBytes;
+    // deepest display list stack, 1 when nothing is called
+    u32 maxDisplayListDepth;
+    u32 matrixPushes;
+    u32 matrixPops;
+    // bytes read from RDRAM by G_LOADBLOCK, G_LOADTILE and G_LOADTLUT
+    u32 textureBytes;
+};
+
+void gfxFrameStatsClear(struct GFXFrameStats* stats);
+// prints the totals followed by the count of each opcode that was used
+void gfxPrintFrameStats(struct GFXFrameStats* stats, gfxPrinter printer);
+
+#endif
\ No newline at end of file
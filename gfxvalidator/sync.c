@@ -0,0 +1,134 @@
+
+#include "validator_internal.h"
+#include "gfx_macros.h"
+
+#ifndef GFX_DISABLE_STANDARD_VALIDATION
+
+// the RDP doesn't wait for earlier primitives before taking new state so
+// changing state a primitive may still be using needs a sync first. the
+// pending flags mean a primitive ran since the last sync, the done flags
+// mean a sync ran and nothing needed it since. both clear means the state
+// isn't known yet, like at the start of a task, and nothing is reported
+#define GFX_SYNC_PIPE_PENDING   (1 << 0)
+#define GFX_SYNC_PIPE_DONE      (1 << 1)
+#define GFX_SYNC_LOAD_PENDING   (1 << 2)
+#define GFX_SYNC_LOAD_DONE      (1 << 3)
+#define GFX_SYNC_TILE_DONE      (1 << 4)
+#define GFX_SYNC_FULL_DONE      (1 << 5)
+
+#define GFX_SYNC_ALL_DONE       (GFX_SYNC_PIPE_DONE | GFX_SYNC_LOAD_DONE | GFX_SYNC_TILE_DONE | GFX_SYNC_FULL_DONE)
+
+// tiles sampled by triangles given the current G_TEXTURE and cycle type
+int gfxPrimitiveTiles(struct GFXValidatorState* state) {
+    struct GFXPipelineState* pipeline = &state->pipeline;
+
+    if (!pipeline->textureOn) {
+        return 0;
+    }
+
+    int tiles = ((2 << pipeline->textureLevels) - 1) << pipeline->textureTile;
+
+    if ((pipeline->othermodeH & (3 << G_MDSFT_CYCLETYPE)) == G_CYC_2CYCLE) {
+        tiles |= 3 << pipeline->textureTile;
+    }
+
+    return tiles & 0xFF;
+}
+
+void gfxRecordPrimitive(struct GFXValidatorState* state, int tiles) {
+    struct GFXPipelineState* pipeline = &state->pipeline;
+
+    pipeline->syncState = (pipeline->syncState & ~GFX_SYNC_ALL_DONE) | GFX_SYNC_PIPE_PENDING;
+
+    if (tiles) {
+        pipeline->syncState |= GFX_SYNC_LOAD_PENDING;
+        pipeline->tileSyncPending |= tiles;
+    }
+}
+
+// loads go through the pipeline and use the load tile but don't need a sync
+// on their own, a sync after one isn't redundant
+void gfxRecordLoad(struct GFXValidatorState* state) {
+    state->pipeline.syncState &= ~(GFX_SYNC_PIPE_DONE | GFX_SYNC_TILE_DONE | GFX_SYNC_FULL_DONE);
+}
+
+enum GFXValidatorError gfxCheckPipeSync(struct GFXValidatorState* state) {
+    if (state->pipeline.syncState & GFX_SYNC_PIPE_PENDING) {
+        gfxSetReason(state, GFXReasonMissingPipeSync);
+        return GFXValidatorMissingSync;
+    }
+
+    return GFXValidatorErrorNone;
+}
+
+enum GFXValidatorError gfxCheckTileSync(struct GFXValidatorState* state, int tile) {
+    if (state->pipeline.tileSyncPending & (1 << tile)) {
+        gfxSetReason(state, GFXReasonMissingTileSync, tile);
+        return GFXValidatorMissingSync;
+    }
+
+    return GFXValidatorErrorNone;
+}
+
+enum GFXValidatorError gfxCheckLoadSync(struct GFXValidatorState* state) {
+    if (state->pipeline.syncState & GFX_SYNC_LOAD_PENDING) {
+        gfxSetReason(state, GFXReasonMissingLoadSync);
+        return GFXValidatorMissingSync;
+    }
+
+    return GFXValidatorErrorNone;
+}
+
+// combiner, othermode, color and image changes must wait for primitives
+enum GFXValidatorError gfxValidateRDPAttribute(struct GFXValidatorState* state, Gfx* at) {
+    return gfxCheckPipeSync(state);
+}
+
+// waits for every primitive to finish so it also covers the tile and load
+// syncs, those aren't reported as redundant after it since the libultra
+// texture macros always include them
+enum GFXValidatorError gfxValidatePipeSync(struct GFXValidatorState* state, Gfx* at) {
+    if (state->pipeline.syncState & GFX_SYNC_PIPE_DONE) {
+        gfxWarn(state, GFXValidatorRedundantSync, GFXReasonRedundantPipeSync);
+    }
+
+    state->pipeline.syncState = (state->pipeline.syncState & ~(GFX_SYNC_PIPE_PENDING | GFX_SYNC_LOAD_PENDING)) | GFX_SYNC_PIPE_DONE;
+    state->pipeline.tileSyncPending = 0;
+
+    return GFXValidatorErrorNone;
+}
+
+enum GFXValidatorError gfxValidateTileSync(struct GFXValidatorState* state, Gfx* at) {
+    if (state->pipeline.syncState & GFX_SYNC_TILE_DONE) {
+        gfxWarn(state, GFXValidatorRedundantSync, GFXReasonRedundantTileSync);
+    }
+
+    state->pipeline.syncState |= GFX_SYNC_TILE_DONE;
+    state->pipeline.tileSyncPending = 0;
+
+    return GFXValidatorErrorNone;
+}
+
+enum GFXValidatorError gfxValidateLoadSync(struct GFXValidatorState* state, Gfx* at) {
+    if (state->pipeline.syncState & GFX_SYNC_LOAD_DONE) {
+        gfxWarn(state, GFXValidatorRedundantSync, GFXReasonRedundantLoadSync);
+    }
+
+    state->pipeline.syncState = (state->pipeline.syncState & ~GFX_SYNC_LOAD_PENDING) | GFX_SYNC_LOAD_DONE;
+
+    return GFXValidatorErrorNone;
+}
+
+// waits for the whole pipeline so it covers every other sync
+enum GFXValidatorError gfxValidateFullSync(struct GFXValidatorState* state, Gfx* at) {
+    if (state->pipeline.syncState & GFX_SYNC_FULL_DONE) {
+        gfxWarn(state, GFXValidatorRedundantSync, GFXReasonRedundantFullSync);
+    }
+
+    state->pipeline.syncState = GFX_SYNC_ALL_DONE;
+    state->pipeline.tileSyncPending = 0;
+
+    return GFXValidatorErrorNone;
+}
+
+#endif
\ No newline at end of file
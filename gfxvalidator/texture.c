@@ -0,0 +1,450 @@
+
+#include "validator_internal.h"
+#include "gfx_macros.h"
+
+#define TILE_INDEX(gfx)     _SHIFTR(GFX_W1(gfx), 24, 3)
+
+#define TILE_ULS(gfx)       _SHIFTR(GFX_W0(gfx), 12, 12)
+#define TILE_ULT(gfx)       _SHIFTR(GFX_W0(gfx), 0, 12)
+#define TILE_LRS(gfx)       _SHIFTR(GFX_W1(gfx), 12, 12)
+#define TILE_LRT(gfx)       _SHIFTR(GFX_W1(gfx), 0, 12)
+
+#define TMEM_HALF           (GFX_TMEM_WORDS / 2)
+
+enum GFXValidatorError gfxValidateSetTextureImage(struct GFXValidatorState* state, Gfx* at) {
+    struct GFXImage* image = &state->pipeline.textureImage;
+    int format = _SHIFTR(GFX_W0(at), 21, 3);
+
+    if (format > G_IM_FMT_I) {
+        gfxSetReason(state, GFXReasonTextureFormat, format);
+        return GFXValidatorInvalidArguments;
+    }
+
+    image->format = format;
+    image->size = _SHIFTR(GFX_W0(at), 19, 2);
+    image->width = _SHIFTR(GFX_W0(at), 0, 12) + 1;
+    state->pipeline.flags |= GFX_INITIALIZED_TIMG;
+
+    // only the first row, the rest isn't known until a load
+    enum GFXValidatorError result = gfxValidateAddress(state, DMA_ADDR(at), ((u32)image->width << image->size) >> 1, 8);
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    // the RSP translates the segment here, not when the load runs
+    int translated;
+    gfxTranslateAddress(state, DMA_ADDR(at), &translated);
+    image->address = translated & 0xFFFFFFF;
+
+    return GFXValidatorErrorNone;
+}
+
+enum GFXValidatorError gfxValidateSetTileCheap(struct GFXValidatorState* state, Gfx* at) {
+    int tileIndex = TILE_INDEX(at);
+    struct GFXTile* tile = &state->pipeline.tiles[tileIndex];
+    int format = _SHIFTR(GFX_W0(at), 21, 3);
+
+    if (format > G_IM_FMT_I) {
+        gfxSetReason(state, GFXReasonTileFormat, format);
+        return GFXValidatorInvalidArguments;
+    }
+
+    tile->format = format;
+    tile->size = _SHIFTR(GFX_W0(at), 19, 2);
+    tile->line = _SHIFTR(GFX_W0(at), 9, 9);
+    tile->tmem = _SHIFTR(GFX_W0(at), 0, 9);
+    tile->palette = _SHIFTR(GFX_W1(at), 20, 4);
+    state->pipeline.initializedTiles |= 1 << tileIndex;
+
+    return GFXValidatorErrorNone;
+}
+
+enum GFXValidatorError gfxValidateSetTileSizeCheap(struct GFXValidatorState* state, Gfx* at) {
+    int tileIndex = TILE_INDEX(at);
+    struct GFXTile* tile = &state->pipeline.tiles[tileIndex];
+
+    tile->uls = TILE_ULS(at);
+    tile->ult = TILE_ULT(at);
+    tile->lrs = TILE_LRS(at);
+    tile->lrt = TILE_LRT(at);
+
+    if (tile->lrs < tile->uls || tile->lrt < tile->ult) {
+        gfxSetReason(state, GFXReasonTileNegative, tileIndex);
+        return GFXValidatorInvalidArguments;
+    }
+
+    return GFXValidatorErrorNone;
+}
+
+enum GFXValidatorError gfxValidateLoadBlockCheap(struct GFXValidatorState* state, Gfx* at) {
+    if ((int)TILE_LRS(at) < (int)TILE_ULS(at)) {
+        gfxSetReason(state, GFXReasonLoadBlockEmpty);
+        return GFXValidatorInvalidArguments;
+    }
+
+    return GFXValidatorErrorNone;
+}
+
+enum GFXValidatorError gfxValidateLoadTileCheap(struct GFXValidatorState* state, Gfx* at) {
+    if ((TILE_LRS(at) >> 2) < (TILE_ULS(at) >> 2) || (TILE_LRT(at) >> 2) < (TILE_ULT(at) >> 2)) {
+        gfxSetReason(state, GFXReasonLoadTileNegative);
+        return GFXValidatorInvalidArguments;
+    }
+
+    return GFXValidatorErrorNone;
+}
+
+// each palette entry is quadricated into a whole TMEM word in the upper half
+enum GFXValidatorError gfxCheckPaletteRange(struct GFXValidatorState* state, int start, int entries) {
+    if (start < TMEM_HALF) {
+        gfxSetReason(state, GFXReasonPaletteLowerHalf, start);
+        return GFXValidatorInvalidArguments;
+    }
+
+    if (entries <= 0 || start + entries > GFX_TMEM_WORDS) {
+        gfxSetReason(state, GFXReasonPaletteOverflow, entries, start);
+        return GFXValidatorInvalidArguments;
+    }
+
+    return GFXValidatorErrorNone;
+}
+
+enum GFXValidatorError gfxValidateLoadTLUTCheap(struct GFXValidatorState* state, Gfx* at) {
+    int tileIndex = TILE_INDEX(at);
+    int entries = (TILE_LRS(at) >> 2) - (TILE_ULS(at) >> 2) + 1;
+    int start = state->pipeline.tiles[tileIndex].tmem;
+
+    // only the size fits somewhere for a tile set before the task started
+    if (!(state->pipeline.initializedTiles & (1 << tileIndex))) {
+        start = TMEM_HALF;
+    }
+
+    return gfxCheckPaletteRange(state, start, entries);
+}
+
+#ifndef GFX_DISABLE_STANDARD_VALIDATION
+
+enum GFXValidatorError gfxCheckLoadSource(struct GFXValidatorState* state, int tileIndex) {
+    enum GFXValidatorError result = gfxCheckLoadSync(state);
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    gfxRecordLoad(state);
+
+    if (!(state->pipeline.flags & GFX_INITIALIZED_TIMG)) {
+        gfxSetReason(state, GFXReasonNoTextureImage);
+        return GFXValidatorUnitialized;
+    }
+
+    if (!(state->pipeline.initializedTiles & (1 << tileIndex))) {
+        gfxSetReason(state, GFXReasonLoadTileNotSet, tileIndex);
+        return GFXValidatorUnitialized;
+    }
+
+    return GFXValidatorErrorNone;
+}
+
+enum GFXValidatorError gfxValidateSetTile(struct GFXValidatorState* state, Gfx* at) {
+    enum GFXValidatorError result = gfxCheckTileSync(state, TILE_INDEX(at));
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    return gfxValidateSetTileCheap(state, at);
+}
+
+enum GFXValidatorError gfxValidateSetTileSizeStandard(struct GFXValidatorState* state, Gfx* at) {
+    int tileIndex = TILE_INDEX(at);
+    enum GFXValidatorError result = gfxCheckTileSync(state, tileIndex);
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    if (!(state->pipeline.initializedTiles & (1 << tileIndex))) {
+        gfxSetReason(state, GFXReasonTileSizeNotSet, tileIndex);
+        return GFXValidatorUnitialized;
+    }
+
+    return gfxValidateSetTileSizeCheap(state, at);
+}
+
+enum GFXValidatorError gfxValidateLoadBlockStandard(struct GFXValidatorState* state, Gfx* at) {
+    int tileIndex = TILE_INDEX(at);
+    enum GFXValidatorError result = gfxCheckLoadSource(state, tileIndex);
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    struct GFXTile* tile = &state->pipeline.tiles[tileIndex];
+    int texels = TILE_LRS(at) - TILE_ULS(at) + 1;
+
+    if (texels <= 0) {
+        gfxSetReason(state, GFXReasonLoadBlockEmpty);
+        return GFXValidatorInvalidArguments;
+    }
+
+    // texel size comes from the load tile, 4 bit texels are half a byte
+    int bytes = (texels << tile->size) >> 1;
+    GFX_STAT_ADD(state, textureBytes, bytes);
+
+    struct GFXImage* image = &state->pipeline.textureImage;
+    u32 first = ((TILE_ULT(at) * image->width + TILE_ULS(at)) << tile->size) >> 1;
+    gfxRecordRead(state, image->address + first, bytes);
+
+    return GFXValidatorErrorNone;
+}
+
+enum GFXValidatorError gfxValidateLoadTileStandard(struct GFXValidatorState* state, Gfx* at) {
+    int tileIndex = TILE_INDEX(at);
+    enum GFXValidatorError result = gfxCheckLoadSource(state, tileIndex);
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    struct GFXTile* tile = &state->pipeline.tiles[tileIndex];
+    int width = (TILE_LRS(at) >> 2) - (TILE_ULS(at) >> 2) + 1;
+    int height = (TILE_LRT(at) >> 2) - (TILE_ULT(at) >> 2) + 1;
+
+    if (width <= 0 || height <= 0) {
+        gfxSetReason(state, GFXReasonLoadTileNegative);
+        return GFXValidatorInvalidArguments;
+    }
+
+    int rowBytes = ((width << tile->size) >> 1);
+    // 32 bit rows are split between the two halves of TMEM so the line of
+    // a 32 bit tile only covers 16 bits of each texel
+    int rowWords = tile->size == G_IM_SIZ_32b ? (width * 2 + 7) >> 3 : (rowBytes + 7) >> 3;
+
+    if (tile->line < rowWords) {
+        gfxSetReason(state, GFXReasonTileLineShort, tileIndex, tile->line, width);
+        return GFXValidatorInvalidArguments;
+    }
+
+    GFX_STAT_ADD(state, textureBytes, rowBytes * height);
+
+    if (state->hazards) {
+        struct GFXImage* image = &state->pipeline.textureImage;
+        u32 imageRowBytes = ((u32)image->width << image->size) >> 1;
+        u32 rowStart = image->address + (((TILE_ULS(at) >> 2) << tile->size) >> 1);
+        int row;
+
+        for (row = TILE_ULT(at) >> 2; row <= (int)(TILE_LRT(at) >> 2); ++row) {
+            gfxRecordRead(state, rowStart + row * imageRowBytes, rowBytes);
+        }
+    }
+
+    return GFXValidatorErrorNone;
+}
+
+enum GFXValidatorError gfxValidateLoadTLUTStandard(struct GFXValidatorState* state, Gfx* at) {
+    int tileIndex = TILE_INDEX(at);
+    enum GFXValidatorError result = gfxCheckLoadSource(state, tileIndex);
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    int entries = (TILE_LRS(at) >> 2) - (TILE_ULS(at) >> 2) + 1;
+    result = gfxCheckPaletteRange(state, state->pipeline.tiles[tileIndex].tmem, entries);
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    // palette entries are 16 bit
+    GFX_STAT_ADD(state, textureBytes, entries * 2);
+    gfxRecordRead(state, state->pipeline.textureImage.address + (TILE_ULS(at) >> 2) * 2, entries * 2);
+
+    return GFXValidatorErrorNone;
+}
+
+#endif
+
+#ifndef GFX_DISABLE_EXHAUSTIVE_VALIDATION
+
+void gfxBitRangeMasks(int start, int end, int index, u32* mask) {
+    int wordStart = index * 32;
+    int from = start > wordStart ? start - wordStart : 0;
+    int to = end < wordStart + 32 ? end - wordStart : 32;
+
+    *mask = (to == 32 ? 0xFFFFFFFF : ((1u << to) - 1)) & ~((1u << from) - 1);
+}
+
+void gfxSetBitRange(u32* bits, int start, int end) {
+    int i;
+    u32 mask;
+
+    for (i = start >> 5; i < ((end + 31) >> 5); ++i) {
+        gfxBitRangeMasks(start, end, i, &mask);
+        bits[i] |= mask;
+    }
+}
+
+void gfxClearBitRange(u32* bits, int start, int end) {
+    int i;
+    u32 mask;
+
+    for (i = start >> 5; i < ((end + 31) >> 5); ++i) {
+        gfxBitRangeMasks(start, end, i, &mask);
+        bits[i] &= ~mask;
+    }
+}
+
+int gfxAllBitsSet(u32* bits, int start, int end) {
+    int i;
+    u32 mask;
+
+    for (i = start >> 5; i < ((end + 31) >> 5); ++i) {
+        gfxBitRangeMasks(start, end, i, &mask);
+
+        if ((bits[i] & mask) != mask) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+int gfxAnyBitsSet(u32* bits, int start, int end) {
+    int i;
+    u32 mask;
+
+    for (i = start >> 5; i < ((end + 31) >> 5); ++i) {
+        gfxBitRangeMasks(start, end, i, &mask);
+
+        if (bits[i] & mask) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+// marks [tmem, tmem + words) as loaded, 32 bit textures are split with the
+// second half of each texel in the upper half of TMEM and words is the
+// length of each half
+enum GFXValidatorError gfxLoadTMEM(struct GFXValidatorState* state, struct GFXTile* tile, int words) {
+    struct GFXPipelineState* pipeline = &state->pipeline;
+    int start = tile->tmem;
+    int end;
+    int limit = GFX_TMEM_WORDS;
+
+    if (tile->size == G_IM_SIZ_32b) {
+        limit = TMEM_HALF;
+    } else if (tile->format == G_IM_FMT_CI) {
+        limit = TMEM_HALF;
+    }
+
+    end = start + words;
+
+    if (end > limit) {
+        if (tile->format == G_IM_FMT_CI) {
+            gfxSetReason(state, GFXReasonCILoadOverlapsPalette, start);
+        } else {
+            gfxSetReason(state, GFXReasonLoadOverflow, start, words);
+        }
+        return GFXValidatorInvalidArguments;
+    }
+
+    if ((pipeline->othermodeH & (3 << G_MDSFT_TEXTLUT)) != G_TT_NONE && gfxAnyBitsSet(pipeline->tmemPalette, start, end)) {
+        gfxSetReason(state, GFXReasonLoadOverwritesPalette, start);
+        return GFXValidatorInvalidArguments;
+    }
+
+    gfxSetBitRange(pipeline->tmemLoaded, start, end);
+    gfxClearBitRange(pipeline->tmemPalette, start, end);
+
+    if (tile->size == G_IM_SIZ_32b) {
+        gfxSetBitRange(pipeline->tmemLoaded, start + TMEM_HALF, end + TMEM_HALF);
+        gfxClearBitRange(pipeline->tmemPalette, start + TMEM_HALF, end + TMEM_HALF);
+    }
+
+    return GFXValidatorErrorNone;
+}
+
+enum GFXValidatorError gfxValidateSetTileSize(struct GFXValidatorState* state, Gfx* at) {
+    int tileIndex = TILE_INDEX(at);
+    struct GFXTile* tile = &state->pipeline.tiles[tileIndex];
+    enum GFXValidatorError result = gfxValidateSetTileSizeStandard(state, at);
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    // the load tile is sized before the load, only check tiles that are
+    // sampled from
+    if (tileIndex == G_TX_LOADTILE || tile->line == 0) {
+        return GFXValidatorErrorNone;
+    }
+
+    // the line of a 32 bit tile is already the length of a row in each half
+    int height = (tile->lrt >> 2) - (tile->ult >> 2) + 1;
+    int start = tile->tmem;
+    int end = start + tile->line * height;
+    // the high half of each 32 bit texel is in the upper half of TMEM
+    int limit = tile->size == G_IM_SIZ_32b ? TMEM_HALF : GFX_TMEM_WORDS;
+
+    if (end > limit || !gfxAllBitsSet(state->pipeline.tmemLoaded, start, end) ||
+        (tile->size == G_IM_SIZ_32b && !gfxAllBitsSet(state->pipeline.tmemLoaded, start + TMEM_HALF, end + TMEM_HALF))) {
+        gfxSetReason(state, GFXReasonTileNotLoaded, tileIndex, start, end);
+        return GFXValidatorInvalidArguments;
+    }
+
+    return GFXValidatorErrorNone;
+}
+
+enum GFXValidatorError gfxValidateLoadBlock(struct GFXValidatorState* state, Gfx* at) {
+    struct GFXTile* tile = &state->pipeline.tiles[TILE_INDEX(at)];
+    enum GFXValidatorError result = gfxValidateLoadBlockStandard(state, at);
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    int bytes = ((TILE_LRS(at) - TILE_ULS(at) + 1) << tile->size) >> 1;
+
+    if (tile->size == G_IM_SIZ_32b) {
+        // each half holds 16 bits of every texel
+        bytes >>= 1;
+    }
+
+    return gfxLoadTMEM(state, tile, (bytes + 7) >> 3);
+}
+
+enum GFXValidatorError gfxValidateLoadTile(struct GFXValidatorState* state, Gfx* at) {
+    struct GFXTile* tile = &state->pipeline.tiles[TILE_INDEX(at)];
+    enum GFXValidatorError result = gfxValidateLoadTileStandard(state, at);
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    int height = (TILE_LRT(at) >> 2) - (TILE_ULT(at) >> 2) + 1;
+
+    return gfxLoadTMEM(state, tile, tile->line * height);
+}
+
+enum GFXValidatorError gfxValidateLoadTLUT(struct GFXValidatorState* state, Gfx* at) {
+    enum GFXValidatorError result = gfxValidateLoadTLUTStandard(state, at);
+
+    if (result != GFXValidatorErrorNone) {
+        return result;
+    }
+
+    int start = state->pipeline.tiles[TILE_INDEX(at)].tmem;
+    int end = start + (TILE_LRS(at) >> 2) - (TILE_ULS(at) >> 2) + 1;
+
+    gfxSetBitRange(state->pipeline.tmemLoaded, start, end);
+    gfxSetBitRange(state->pipeline.tmemPalette, start, end);
+
+    return GFXValidatorErrorNone;
+}
+
+#endif
\ No newline at end of file
@@ -1,71 +1,357 @@
 
-#include "validator.h"
+#include "validator_internal.h"
 #include <string.h>
+#include <stdarg.h>
 #include "gfx_macros.h"
+#include "cache.h"
+#include "diagnostics.h"
+#include "sampler.h"
 
-typedef enum GFXValidatorError (*CommandValidator)(struct GFXValidatorState* state, Gfx* at);
+#ifdef GFX_HOST
+#include <stdio.h>
+#include <time.h>
+#endif
 
-extern CommandValidator gfxCommandValidators[GFX_MAX_COMMAND_LEN];
+// how many commands run between checks of the cycle budget
+#define GFX_CYCLE_CHECK_INTERVAL    32
+#define GFX_UNLIMITED_SLICE         0x7FFFFFFF
 
+#ifdef GFX_HOST
+// nanoseconds stand in for cycles on the host
+u32 gfxCycleCount() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (u32)now.tv_sec * 1000000000u + (u32)now.tv_nsec;
+}
+#else
+#define gfxCycleCount() osGetCount()
+#endif
 
-void gfxInitState(struct GFXValidatorState* state, struct GFXValidationResult* result) {
+void gfxInitState(struct GFXValidatorState* state, struct GFXValidationResult* result, struct GFXValidatorOptions* options, int maxGfxCount) {
     int i;
 
+    // clear any padding so the validation cache can hash the pipeline state
+    memset(&state->pipeline, 0, sizeof(state->pipeline));
+
     for (i = 0; i < GFX_MAX_SEGMENTS; ++i) {
-        state->segments[i] = SEGMENT_UNINITIALIZED;
+        state->pipeline.segments[i] = options->segments ? (int)options->segments[i] : SEGMENT_UNINITIALIZED;
     }
 
     state->result = result;
+    state->memory = options->memory;
+    state->microcode = options->microcode ? options->microcode : gfxDefaultMicrocode();
+    state->level = options->level < GFXValidationLevelCount ? options->level : GFXValidationCheap;
+
+    // the cheap validators don't follow texture loads
+    if (options->hazards && state->level == GFXValidationCheap) {
+        state->level = GFXValidationStandard;
+    }
+
+    state->sampler = 0;
+    state->sampleLevel = state->level;
+    state->baseLevel = options->hazards ? GFXValidationStandard : GFXValidationCheap;
+    state->sampleDepth = 0;
+
+    if (options->sampler && state->baseLevel > state->level && !gfxSamplerBeginFrame(options->sampler)) {
+        state->sampler = options->sampler;
+        state->level = state->baseLevel;
+    }
+
+    state->validators = state->microcode->validators[state->level];
+    state->regions = options->regions;
+    state->hazards = options->hazards;
 
-    state->matrixStackSize = 0;
+#ifndef GFX_HOST
+    if (!state->memory) {
+        gfxConsoleMemoryInit(&state->defaultMemory);
+        state->memory = &state->defaultMemory;
+    }
+#endif
+
+    state->pipeline.matrixStackSize = 0;
     state->result->gfxStackSize = 0;
+    state->result->microcode = state->microcode->id;
     state->result->reason = GFXValidatorErrorNone;
-    state->result->reasonMessage[0] = 0;
-    state->flags = 0;
+    state->result->reasonId = GFXReasonNone;
+    state->reasonId = GFXReasonNone;
+    state->pipeline.flags = 0;
+    state->gfxStackSize = 0;
+    state->commandsRemaining = maxGfxCount;
+
+    for (i = 0; i < GFX_BRANCH_SET_SIZE; ++i) {
+        state->branches.addresses[i] = 0;
+    }
+
+    state->branches.logSize = 0;
+    // a cached display list isn't walked so its reads wouldn't be marked
+    state->cache = options->hazards ? 0 : options->cache;
+    state->onWarning = options->onWarning;
+    state->warningData = options->warningData;
+    state->diagnostics = options->diagnostics;
+    state->visitor = options->visitor;
+    state->visitorData = options->visitorData;
+#ifndef GFX_DISABLE_STATS
+    state->stats = options->stats;
+#endif
+    state->recoveredError = GFXValidatorErrorNone;
+    state->streamEnd = GFX_NO_STREAM_END;
+    state->sliceCommandsRemaining = GFX_UNLIMITED_SLICE;
+    state->sliceCycles = 0;
+}
+
+#define GFX_BRANCH_KEY(address)     ((address) | 1)
+
+int gfxBranchSetFind(struct GFXBranchSet* branches, u32 address) {
+    u32 key = GFX_BRANCH_KEY(address);
+    int slot = (key >> 3) & (GFX_BRANCH_SET_SIZE - 1);
+
+    while (branches->addresses[slot]) {
+        if (branches->addresses[slot] == key) {
+            return slot;
+        }
+
+        slot = (slot + 1) & (GFX_BRANCH_SET_SIZE - 1);
+    }
+
+    return -1 - slot;
+}
+
+void gfxBranchSetAdd(struct GFXBranchSet* branches, int freeSlot, u32 address) {
+    // once full, loops are only caught by the command limit
+    if (branches->logSize == GFX_MAX_BRANCH_TARGETS) {
+        return;
+    }
+
+    branches->addresses[freeSlot] = GFX_BRANCH_KEY(address);
+    branches->log[(int)branches->logSize++] = freeSlot;
+}
+
+void gfxBranchSetRewind(struct GFXBranchSet* branches, int logSize) {
+    // removing linear probing entries in the reverse order they were
+    // added leaves the set exactly as it was before they were added
+    while (branches->logSize > logSize) {
+        branches->addresses[branches->log[(int)--branches->logSize]] = 0;
+    }
+}
+
+Gfx* gfxResolveList(struct GFXValidatorState* state, u32 address) {
+    Gfx* result = gfxMemoryResolve(state->memory, address, sizeof(Gfx));
+
+    if (!result) {
+        gfxSetReason(state, GFXReasonListNotInRAM, (unsigned)address);
+    }
+
+    return result;
+}
+
+void gfxSetLevel(struct GFXValidatorState* state, enum GFXValidationLevel level) {
+    state->level = level;
+    state->validators = state->microcode->validators[level];
+}
+
+// checks the display list about to be pushed at sampleLevel if the sampler
+// picks it. TMEM and, below GFXValidationStandard, the syncs aren't followed
+// outside of sampled lists so they are assumed to be what the list expects
+void gfxBeginSample(struct GFXValidatorState* state, u32 address) {
+    struct GFXPipelineState* pipeline = &state->pipeline;
+
+    if (!gfxSamplerPickList(state->sampler, address)) {
+        return;
+    }
+
+    memset(pipeline->tmemLoaded, 0xFF, sizeof(pipeline->tmemLoaded));
+    memset(pipeline->tmemPalette, 0, sizeof(pipeline->tmemPalette));
+
+    if (state->baseLevel == GFXValidationCheap) {
+        pipeline->syncState = 0;
+        pipeline->tileSyncPending = 0;
+    }
 
+    state->sampleDepth = state->gfxStackSize + 1;
+    gfxSetLevel(state, state->sampleLevel);
 }
 
-enum GFXValidatorError gfxPush(struct GFXValidatorState* state, Gfx* next) {
-    if (state->result->gfxStackSize == GFX_MAX_GFX_STACK) {
-        sprintf(state->result->reasonMessage, "display list stack overflow");
+// goes back to baseLevel once the sampled display list has returned
+void gfxEndSample(struct GFXValidatorState* state) {
+    if (state->sampleDepth > state->gfxStackSize) {
+        state->sampleDepth = 0;
+        gfxSetLevel(state, state->baseLevel);
+    }
+}
+
+enum GFXValidatorError gfxPush(struct GFXValidatorState* state, u32 address) {
+    if (state->gfxStackSize == GFX_MAX_GFX_STACK) {
+        gfxSetReason(state, GFXReasonListStackOverflow);
         return GFXValidatorStackOverflow;
-    } else {
-        state->result->gfxStack[(int)state->result->gfxStackSize++] = next;
-        return GFXValidatorErrorNone;
     }
+
+    Gfx* gfx = gfxResolveList(state, address);
+
+    if (!gfx) {
+        return GFXValidatorInvalidAddress;
+    }
+
+    struct GFXDisplayListFrame* frame = &state->gfxStack[(int)state->gfxStackSize++];
+    frame->gfx = gfx;
+    frame->address = address;
+    frame->startAddress = address;
+    frame->branchLogStart = state->branches.logSize;
+    frame->cacheable = 0;
+    GFX_STAT_MAX(state, maxDisplayListDepth, state->gfxStackSize);
+
+    int slot = gfxBranchSetFind(&state->branches, address);
+
+    if (slot < 0) {
+        gfxBranchSetAdd(&state->branches, -1 - slot, address);
+    }
+
+    return GFXValidatorErrorNone;
 }
 
 void gfxPop(struct GFXValidatorState* state) {
-    state->result->gfxStackSize--;
+    struct GFXDisplayListFrame* frame = &state->gfxStack[(int)--state->gfxStackSize];
+    gfxBranchSetRewind(&state->branches, frame->branchLogStart);
+
+    if (frame->cacheable) {
+        gfxCacheStore(
+            state->cache, 
+            frame->listAddress, 
+            frame->cacheKey, 
+            frame->commandsRemainingAtEntry - state->commandsRemaining, 
+            &state->pipeline
+        );
+    }
+
+    gfxEndSample(state);
+
+    if (state->gfxStackSize) {
+        // resume after the G_DL that pushed the frame
+        frame = &state->gfxStack[state->gfxStackSize - 1];
+        ++frame->gfx;
+        frame->address += sizeof(Gfx);
+    }
+}
+
+enum GFXValidatorError gfxCallList(struct GFXValidatorState* state, u32 address) {
+    if (!state->cache) {
+        return gfxPush(state, address);
+    }
+
+    u32 key = gfxCacheKey(&state->pipeline, state->gfxStackSize, state->microcode->id, state->level);
+    struct GFXCacheEntry* entry = gfxCacheFind(state->cache, address, key, &state->pipeline, state->gfxStackSize, state->microcode->id, state->level);
+
+    // a hit that would go over the command limit is walked again so the
+    // error points at the right command
+    if (entry && entry->commandCount <= state->commandsRemaining) {
+        struct GFXDisplayListFrame* frame = &state->gfxStack[state->gfxStackSize - 1];
+        state->pipeline = entry->exitState;
+        state->commandsRemaining -= entry->commandCount;
+        ++frame->gfx;
+        frame->address += sizeof(Gfx);
+        return GFXValidatorErrorNone;
+    }
+
+    // taken before the push since that changes the stack depth
+    gfxCacheBegin(state->cache, address, key, &state->pipeline, state->gfxStackSize, state->microcode->id, state->level);
+
+    enum GFXValidatorError result = gfxPush(state, address);
+
+    if (result == GFXValidatorErrorNone) {
+        struct GFXDisplayListFrame* frame = &state->gfxStack[state->gfxStackSize - 1];
+        frame->cacheable = 1;
+        frame->listAddress = address;
+        frame->cacheKey = key;
+        frame->commandsRemainingAtEntry = state->commandsRemaining;
+    }
+
+    return result;
+}
+
+enum GFXValidatorError gfxBranch(struct GFXValidatorState* state, u32 address) {
+    struct GFXDisplayListFrame* frame = &state->gfxStack[state->gfxStackSize - 1];
+    int slot = gfxBranchSetFind(&state->branches, address);
+
+    if (slot >= 0) {
+        gfxSetReason(state, GFXReasonBranchLoop, (unsigned)address);
+        return GFXValidatorInfiniteLoop;
+    }
+
+    Gfx* gfx = gfxResolveList(state, address);
+
+    if (!gfx) {
+        return GFXValidatorInvalidAddress;
+    }
+
+    gfxBranchSetAdd(&state->branches, -1 - slot, address);
+    frame->gfx = gfx;
+    frame->address = address;
+    frame->startAddress = address;
+
+    return GFXValidatorErrorNone;
+}
+
+// G_BRANCH_Z only branches when a vertex is closer than a given depth so
+// the target is walked like a call, followed by the rest of this list
+enum GFXValidatorError gfxBranchZ(struct GFXValidatorState* state, u32 address) {
+    if (gfxBranchSetFind(&state->branches, address) >= 0) {
+        gfxSetReason(state, GFXReasonBranchLoop, (unsigned)address);
+        return GFXValidatorInfiniteLoop;
+    }
+
+    return gfxPush(state, address);
 }
 
 int gfxIsAligned(int addr, int to) {
     return (addr & ~(to - 1)) == addr;
 }
 
-int gfxIsInRam(int addr) {
+int gfxIsInRam(struct GFXValidatorState* state, int addr) {
     addr = addr & 0xFFFFFFF;
-    return addr > 0 && addr < osMemSize;
+    return addr > 0 && addr < state->memory->size;
 }
 
-int gfxIsValidSegmentAddress(int addr) {
-    return gfxIsInRam(addr) || addr == 0;
+int gfxIsValidSegmentAddress(struct GFXValidatorState* state, int addr) {
+    return gfxIsInRam(state, addr) || addr == 0;
 }
 
 enum GFXValidatorError gfxTranslateAddress(struct GFXValidatorState* state, int address, int* output) {
     int segment = _SHIFTR(address, 24, 4);
 
-    if (segment < 0 || segment >= 16 || state->segments[segment] == SEGMENT_UNINITIALIZED) {
-        sprintf(state->result->reasonMessage, "attempt to use segment 0x%x before it was initialized", segment);
+    if (segment < 0 || segment >= 16 || state->pipeline.segments[segment] == SEGMENT_UNINITIALIZED) {
+        gfxSetReason(state, GFXReasonSegmentUninitialized, segment);
         return GFXValidatorSegmentError;
     } else {
-        *output = state->segments[segment] + (address & 0xFFFFFF);
+        *output = state->pipeline.segments[segment] + (address & 0xFFFFFF);
     }
 
     return GFXValidatorErrorNone;
 }
 
-enum GFXValidatorError gfxValidateAddress(struct GFXValidatorState* state, int address, int alignedTo) {
+enum GFXValidatorError gfxCheckRegion(struct GFXValidatorState* state, int address, u32 physical, u32 length) {
+#ifdef GFX_DISABLE_EXHAUSTIVE_VALIDATION
+    return GFXValidatorErrorNone;
+#else
+    if (!state->regions || state->level != GFXValidationExhaustive) {
+        return GFXValidatorErrorNone;
+    }
+
+    const struct GFXRegion* region = gfxRegionFind(state->regions, physical);
+
+    if (!region) {
+        gfxSetReason(state, GFXReasonAddressNotRegistered, address, physical);
+        return GFXValidatorInvalidAddress;
+    }
+
+    if (length > region->end - physical) {
+        gfxSetReason(state, GFXReasonAddressPastRegion, length, physical, region->start);
+        return GFXValidatorInvalidAddress;
+    }
+
+    return GFXValidatorErrorNone;
+#endif
+}
+
+enum GFXValidatorError gfxValidateAddress(struct GFXValidatorState* state, int address, u32 length, int alignedTo) {
     int translated;
     enum GFXValidatorError result = gfxTranslateAddress(state, address, &translated);
 
@@ -74,492 +360,604 @@ enum GFXValidatorError gfxValidateAddress(struct GFXValidatorState* state, int a
     }
 
     if (!gfxIsAligned(translated, alignedTo)) {
-        sprintf(state->result->reasonMessage, "address 0x%08x must to aligned to %d bytes", address, alignedTo);
+        gfxSetReason(state, GFXReasonAlignment, address, alignedTo);
         return GFXValidatorDataAlignment;
     }
 
-    if (!gfxIsInRam(translated)) {
-        sprintf(state->result->reasonMessage, "address 0x%08x translates to 0x%08x which isn't in RAM", address, translated);
+    if (!gfxIsInRam(state, translated)) {
+        gfxSetReason(state, GFXReasonAddressNotInRAM, address, translated);
         return GFXValidatorInvalidAddress;
     }
 
-    return GFXValidatorErrorNone;
-}
+    u32 physical = translated & 0xFFFFFFF;
 
-enum GFXValidatorError gfxValidateNoop(struct GFXValidatorState* state, Gfx* at) {
-    if (at->dma.addr != 0 || at->dma.len != 0 || at->dma.par != 0) {
-        sprintf(state->result->reasonMessage, "nop instruction should equal 0");
-        return GFXValidatorInvalidArguments;
-    } else {
-        return GFXValidatorErrorNone;
+    if (length > state->memory->size - physical) {
+        gfxSetReason(state, GFXReasonAddressRangePastRAM, length, physical);
+        return GFXValidatorInvalidAddress;
     }
-}
 
-enum GFXValidatorError gfxValidateMtx(struct GFXValidatorState* state, Gfx* at) {
-    int flags = DMA_MM_IDX(at);
-
-#ifdef F3DEX_GBI_2
-    flags ^= G_MTX_PUSH;
-#endif
+    return gfxCheckRegion(state, address, physical, length);
+}
 
-    if (DMA_MM_LEN(at) != DMA_MM_EXPECTED_SIZE(sizeof(Mtx))) {
-        sprintf(state->result->reasonMessage, "malformed matrix operation");
-        return GFXValidatorInvalidArguments;
-    } else if (flags < 0 || flags > (G_MTX_PROJECTION | G_MTX_LOAD | G_MTX_PUSH)) {
-        sprintf(state->result->reasonMessage, "invalid matrix flags");
-        return GFXValidatorInvalidArguments;
-    } else if ((flags & G_MTX_PUSH) && state->matrixStackSize == GFX_MAX_MATRIX_STACK) {
-        sprintf(state->result->reasonMessage, "matrix stack overflow");
-        return GFXValidatorStackOverflow;
-    } else if ((flags & G_MTX_PUSH) && (flags & G_MTX_PROJECTION)) {
-        sprintf(state->result->reasonMessage, "cannot push a G_MTX_PROJECTION matrix");
-        return GFXValidatorInvalidArguments;
-    } else {
-        if (!(flags & G_MTX_LOAD)) {
-            if (flags & G_MTX_PROJECTION) {
-                if (!(state->flags & GFX_INITIALIZED_PMTX)) {
-                    sprintf(state->result->reasonMessage, "cannot multiply, no existing matrix exists");
-                    return GFXValidatorUnitialized;
-                }
-            } else {
-                if (!(state->flags & GFX_INITIALIZED_MMTX)) {
-                    sprintf(state->result->reasonMessage, "cannot multiply, no existing matrix exists");
-                    return GFXValidatorUnitialized;
-                }
-            }
-        }
+enum GFXValidatorError gfxValidateRead(struct GFXValidatorState* state, int address, u32 length, int alignedTo) {
+    enum GFXValidatorError result = gfxValidateAddress(state, address, length, alignedTo);
 
-        if ((flags & G_MTX_PUSH)) {
-            ++state->matrixStackSize;
-        }
+    if (result == GFXValidatorErrorNone && state->hazards) {
+        int translated = 0;
+        gfxTranslateAddress(state, address, &translated);
+        gfxHazardMark(state->hazards, translated & 0xFFFFFFF, length);
+    }
 
-        if (flags & G_MTX_PROJECTION) {
-            state->flags |= GFX_INITIALIZED_PMTX;
-        } else {
-            state->flags |= GFX_INITIALIZED_MMTX;
-        }
+    return result;
+}
 
-        return gfxValidateAddress(state, at->dma.addr, 8);
-    }
-}
-
-enum GFXValidatorError gfxValidateMoveMem(struct GFXValidatorState* state, Gfx* at) {
-    int location = DMA_MM_IDX(at);
-    int expectedLen = 0;
-
-    switch (location) {
-        case G_MV_VIEWPORT:
-            expectedLen = DMA_MM_EXPECTED_SIZE(sizeof(Vp));
-            break;
-#ifdef	F3DEX_GBI_2
-        case G_MV_MMTX:
-        case G_MV_PMTX:
-        case G_MV_MATRIX:
-            expectedLen = DMA_MM_EXPECTED_SIZE(16);
-            break;
-        case G_MV_LIGHT:
-            expectedLen = DMA_MM_EXPECTED_SIZE(sizeof(Light));
-            break;
-        case G_MV_POINT:
-            // Not sure what to expect here
-            expectedLen = DMA_MM_LEN(at);
-            break;
-        case G_MVO_LOOKATX:
-        case G_MVO_LOOKATY:
-            expectedLen = DMA_MM_EXPECTED_SIZE(sizeof(Light));
-            break;
-        case G_MVO_L0:
-        case G_MVO_L1:
-        case G_MVO_L2:
-        case G_MVO_L3:
-        case G_MVO_L4:
-        case G_MVO_L5:
-        case G_MVO_L6:
-        case G_MVO_L7:
-            expectedLen = DMA_MM_EXPECTED_SIZE(sizeof(Light));
-            break;
-#else
-        case G_MV_LOOKATY:
-        case G_MV_LOOKATX:
-            expectedLen = sizeof(Light);
-            break;
-        case G_MV_L0:
-        case G_MV_L1:
-        case G_MV_L2:
-        case G_MV_L3:
-        case G_MV_L4:
-        case G_MV_L5:
-        case G_MV_L6:
-        case G_MV_L7:
-            expectedLen = sizeof(Light);
-            break;
-        case G_MV_TXTATT:
-            // Not sure what to expect here
-            expectedLen = DMA_MM_LEN(at);
-            break;
-        case G_MV_MATRIX_1:
-        case G_MV_MATRIX_2:
-        case G_MV_MATRIX_3:
-        case G_MV_MATRIX_4:
-            expectedLen = 16;
-            break;
-#endif
-        default:
-            sprintf(state->result->reasonMessage, "unrecognized copy target");
-            return GFXValidatorInvalidArguments;
+void gfxRecordRead(struct GFXValidatorState* state, u32 physical, u32 length) {
+    if (state->hazards) {
+        gfxHazardMark(state->hazards, physical, length);
     }
+}
 
-    if (expectedLen != DMA_MM_LEN(at)) {
-        sprintf(state->result->reasonMessage, "malformed copy size");
+enum GFXValidatorError gfxValidateNoop(struct GFXValidatorState* state, Gfx* at) {
+    if (DMA_ADDR(at) != 0 || DMA1_LEN(at) != 0 || DMA1_PARAM(at) != 0) {
+        gfxSetReason(state, GFXReasonNoopNotZero);
         return GFXValidatorInvalidArguments;
+    } else {
+        return GFXValidatorErrorNone;
     }
-    
-    return gfxValidateAddress(state, at->dma.addr, 8);
 }
 
-enum GFXValidatorError gfxValidateVertex(struct GFXValidatorState* state, Gfx* at) {
-    int vtxCount;
-    int v0;
-#ifdef F3DEX_GBI_2
-    vtxCount = _SHIFTR(at->words.w0, 12, 8);
-    v0 = _SHIFTR(at->words.w0, 1, 7) - vtxCount;
-#else
-    vtxCount = (DMA1_PARAM(at) >> 4) + 1;
-    v0 = DMA1_PARAM(at) & 0xF;
-
-    if (vtxCount * sizeof(Vtx) != DMA1_LEN(at)) {
-        sprintf(state->result->reasonMessage, "malformed copy size");
+// gsDPNoOpTag leaves a tag in w1 for tracing, only w0 is fixed
+enum GFXValidatorError gfxValidateRDPNoop(struct GFXValidatorState* state, Gfx* at) {
+    if (_SHIFTR(GFX_W0(at), 0, 24) != 0) {
+        gfxSetReason(state, GFXReasonNoopNotZero);
         return GFXValidatorInvalidArguments;
     }
-#endif
 
-    if (vtxCount == 0) {
-        sprintf(state->result->reasonMessage, "must include at least one vertex");
-        return GFXValidatorInvalidArguments;
-    }
+    return GFXValidatorErrorNone;
+}
 
-    if (v0 + vtxCount > VERTEX_BUFFER_SIZE) {
-        sprintf(state->result->reasonMessage, "vertex buffer overflow v0: %d n: %d", v0, vtxCount);
+// w1 means something different to each command that reads it, it is only
+// checked once G_BRANCH_Z uses it as an address
+enum GFXValidatorError gfxValidateRDPHalf1(struct GFXValidatorState* state, Gfx* at) {
+    state->pipeline.rdpHalf1 = GFX_W1(at);
+    state->pipeline.flags |= GFX_INITIALIZED_RDPHALF1;
+    return GFXValidatorErrorNone;
+}
+
+enum GFXValidatorError gfxValidateSetPrimDepth(struct GFXValidatorState* state, Gfx* at) {
+    u32 depth = _SHIFTR(GFX_W1(at), 16, 16);
+
+    // the RDP only keeps 15 bits of the depth
+    if (depth > 0x7FFF) {
+        gfxSetReason(state, GFXReasonPrimDepthRange, depth);
         return GFXValidatorInvalidArguments;
     }
 
-    return gfxValidateAddress(state, at->dma.addr, 8);
+    return GFXValidatorErrorNone;
 }
 
-
 enum GFXValidatorError gfxValidateDL(struct GFXValidatorState* state, Gfx* at) {
     if (DMA1_LEN(at) != 0) {
-        sprintf(state->result->reasonMessage, "malformed length");
+        gfxSetReason(state, GFXReasonListLength);
         return GFXValidatorInvalidArguments;
     } else if (DMA1_PARAM(at) != (DMA1_PARAM(at) & (G_DL_NOPUSH | G_DL_PUSH))) {
-        sprintf(state->result->reasonMessage, "malformed flags");
+        gfxSetReason(state, GFXReasonListFlags);
         return GFXValidatorInvalidArguments;
     } else {
-        return gfxValidateAddress(state, at->dma.addr, 8);
+        return gfxValidateAddress(state, DMA_ADDR(at), sizeof(Gfx), 8);
     }
 }
 
 
 enum GFXValidatorError gfxValidateSprite2DBase(struct GFXValidatorState* state, Gfx* at) {
     if (DMA1_LEN(at) != sizeof(uSprite) || DMA1_PARAM(at) != 0) {
+        gfxSetReason(state, GFXReasonSpriteLength, (int)DMA1_LEN(at), (int)DMA1_PARAM(at), (int)sizeof(uSprite));
         return GFXValidatorInvalidArguments;
     } else {
-        return gfxValidateAddress(state, at->dma.addr, 8);
+        return gfxValidateRead(state, DMA_ADDR(at), sizeof(uSprite), 8);
     }
 }
 
-enum GFXValidatorError gfxCheckTriangle(struct GFXValidatorState* state, int v0, int v1, int v2) {
-    if (v0 >= MAX_VERTEX_VALUE || v1 >= MAX_VERTEX_VALUE || v2 >= MAX_VERTEX_VALUE) {
-        sprintf(state->result->reasonMessage, "vertex index too large for vertex buffer");
+// replaces len bits at sft in mode with the same bits of data
+enum GFXValidatorError gfxSetOtherModeBits(struct GFXValidatorState* state, u32* mode, int sft, int len, u32 data) {
+    if (len <= 0 || sft < 0 || sft + len > 32) {
+        gfxSetReason(state, GFXReasonOtherModeRange, sft, len);
         return GFXValidatorInvalidArguments;
-    } else {
-        return GFXValidatorErrorNone;
     }
-} 
 
-enum GFXValidatorError gfxValidateTri1(struct GFXValidatorState* state, Gfx* at) {
-    int v0 = _SHIFTR(at->words.w1, 16, 8);
-    int v1 = _SHIFTR(at->words.w1, 8, 8);
-    int v2 = _SHIFTR(at->words.w1, 0, 8);
+    u32 mask = (len == 32 ? 0xFFFFFFFF : ((1u << len) - 1)) << sft;
+    *mode = (*mode & ~mask) | (data & mask);
+    state->pipeline.flags |= GFX_RENDER_TARGET_DIRTY;
 
-#ifdef F3DEX_GBI_2
-    v0 = _SHIFTR(at->words.w0, 16, 8);
-    v1 = _SHIFTR(at->words.w0, 8, 8);
-    v2 = _SHIFTR(at->words.w0, 0, 8);
-#else
-    v0 = _SHIFTR(at->words.w1, 16, 8);
-    v1 = _SHIFTR(at->words.w1, 8, 8);
-    v2 = _SHIFTR(at->words.w1, 0, 8);
-    flag = _SHIFTR(at->words.w1, 24, 8);
-#endif
+    return GFXValidatorErrorNone;
+}
 
-    return gfxCheckTriangle(state, v0, v1, v2);
+enum GFXValidatorError gfxValidateRDPSetOtherModeCheap(struct GFXValidatorState* state, Gfx* at) {
+    state->pipeline.othermodeH = _SHIFTR(GFX_W0(at), 0, 24);
+    state->pipeline.othermodeL = GFX_W1(at);
+    state->pipeline.flags |= GFX_RENDER_TARGET_DIRTY;
+    return GFXValidatorErrorNone;
 }
 
-enum GFXValidatorError gfxValidateTri2(struct GFXValidatorState* state, Gfx* at) {
-    enum GFXValidatorError result = gfxCheckTriangle(
-        state, 
-        _SHIFTR(at->words.w0, 16, 8), 
-        _SHIFTR(at->words.w0, 8, 8), 
-        _SHIFTR(at->words.w0, 0, 8)
-    );
+#ifndef GFX_DISABLE_STANDARD_VALIDATION
+// the lights and lookat vectors lit vertices are transformed with
+enum GFXValidatorError gfxCheckLighting(struct GFXValidatorState* state) {
+    struct GFXPipelineState* pipeline = &state->pipeline;
+
+    if (!(pipeline->flags & GFX_INITIALIZED_NUMLIGHT)) {
+        gfxSetReason(state, GFXReasonNoLightCount);
+        return GFXValidatorUnitialized;
+    }
+
+    // directional lights plus the ambient light
+    u16 lights = ((1 << (pipeline->numLights + 1)) - 1) << GFX_FIRST_LIGHT_SLOT;
+
+    if ((pipeline->loadedLights & lights) != lights) {
+        int light;
+
+        for (light = 0; pipeline->loadedLights & (1 << (GFX_FIRST_LIGHT_SLOT + light)); ++light);
+
+        if (light == pipeline->numLights) {
+            gfxSetReason(state, GFXReasonNoAmbientLight, pipeline->numLights);
+        } else {
+            gfxSetReason(state, GFXReasonLightNotLoaded, pipeline->numLights, light + 1);
+        }
+        return GFXValidatorUnitialized;
+    }
+
+    u16 lookat = (1 << GFX_LOOKAT_X_SLOT) | (1 << GFX_LOOKAT_Y_SLOT);
+
+    if ((pipeline->geometryMode & G_TEXTURE_GEN) && (pipeline->loadedLights & lookat) != lookat) {
+        gfxSetReason(state, GFXReasonNoLookAt);
+        return GFXValidatorUnitialized;
+    }
+
+    return GFXValidatorErrorNone;
+}
+
+enum GFXValidatorError gfxSetOtherMode(struct GFXValidatorState* state, u32* mode, int sft, int len, u32 data) {
+    enum GFXValidatorError result = gfxCheckPipeSync(state);
 
     if (result != GFXValidatorErrorNone) {
         return result;
     }
 
-    result = gfxCheckTriangle(
-        state, 
-        _SHIFTR(at->words.w1, 16, 8), 
-        _SHIFTR(at->words.w1, 8, 8), 
-        _SHIFTR(at->words.w1, 0, 8)
-    );
+    return gfxSetOtherModeBits(state, mode, sft, len, data);
+}
+
+enum GFXValidatorError gfxValidateRDPSetOtherMode(struct GFXValidatorState* state, Gfx* at) {
+    enum GFXValidatorError result = gfxCheckPipeSync(state);
 
     if (result != GFXValidatorErrorNone) {
         return result;
     }
 
-    return GFXValidatorErrorNone;
+    return gfxValidateRDPSetOtherModeCheap(state, at);
 }
+#endif // GFX_DISABLE_STANDARD_VALIDATION
 
-enum GFXValidatorError gfxValidateCullDL(struct GFXValidatorState* state, Gfx* at) {
+enum GFXValidatorError gfxValidateTODO(struct GFXValidatorState* state, Gfx* at) {
     return GFXValidatorErrorNone;
 }
 
-enum GFXValidatorError gfxValidatePopMtx(struct GFXValidatorState* state, Gfx* at) {
-    // TODO handle G_SPRITE2D_DRAW in sprite mode
-    int popCount;
-#ifdef F3DEX_GBI_2
-    popCount = at->words.w1 >> 6;
-#else
-    popCount = 1;
-#endif
+// reads an argument for each format specifier in the reason text
+void gfxReadReasonArgs(enum GFXReason reason, u32* output, va_list args) {
+    const char* format = gfxReasonFormats[reason];
+    int count = 0;
 
-    if (state->matrixStackSize < popCount) {
-        sprintf(state->result->reasonMessage, "matrix stack underflow");
-        return GFXValidatorStackUnderflow;
-#ifndef F3DEX_GBI_2
-    } else if (at->words.w1 != G_MTX_MODELVIEW) {
-        return GFXValidatorInvalidArguments;
-#endif
-    } else {
-        state->matrixStackSize -= popCount;
-        return GFXValidatorErrorNone;
+    for (; *format && count < GFX_MAX_REASON_ARGS; ++format) {
+        if (format[0] == '%' && format[1] == '%') {
+            ++format;
+        } else if (format[0] == '%') {
+            output[count++] = va_arg(args, u32);
+        }
     }
+
+    for (; count < GFX_MAX_REASON_ARGS; ++count) {
+        output[count] = 0;
+    }
+}
+
+void gfxSetReason(struct GFXValidatorState* state, enum GFXReason reason, ...) {
+    va_list args;
+
+    va_start(args, reason);
+    gfxReadReasonArgs(reason, state->reasonArgs, args);
+    va_end(args);
+
+    state->reasonId = reason;
+}
+
+void gfxCopyReason(struct GFXValidatorState* state, struct GFXValidationResult* result) {
+    int i;
+
+    result->reasonId = state->reasonId;
+
+    for (i = 0; i < GFX_MAX_REASON_ARGS; ++i) {
+        result->reasonArgs[i] = state->reasonArgs[i];
+    }
+}
+
+void gfxSnapshotStack(struct GFXValidatorState* state, struct GFXValidationResult* result) {
+    for (int i = 0; i < state->gfxStackSize; ++i) {
+        // the innermost list may have run off the end of memory
+        Gfx* gfx = gfxMemoryResolve(state->memory, state->gfxStack[i].address, sizeof(Gfx));
+
+        if (gfx) {
+            result->gfxStack[i] = *gfx;
+        } else {
+            result->gfxStack[i].words.w0 = 0;
+            result->gfxStack[i].words.w1 = 0;
+        }
+
+        result->gfxStackAddress[i] = state->gfxStack[i].address;
+    }
+
+    result->gfxStackSize = state->gfxStackSize;
+    result->microcode = state->microcode->id;
+}
+
+// adds an entry for the current command to the diagnostics log
+struct GFXDiagnostic* gfxLogDiagnostic(struct GFXValidatorState* state, enum GFXValidatorError code, enum GFXDiagnosticSeverity severity) {
+    struct GFXDiagnostic* diagnostic = gfxDiagnosticLogNext(state->diagnostics);
+
+    if (!diagnostic) {
+        return 0;
+    }
+
+    gfxSnapshotStack(state, &diagnostic->location);
+    diagnostic->location.reason = code;
+    diagnostic->severity = severity;
+    diagnostic->address = state->gfxStackSize ? state->gfxStack[state->gfxStackSize - 1].address : 0;
+
+    return diagnostic;
 }
 
+void gfxWarn(struct GFXValidatorState* state, enum GFXValidatorError warning, enum GFXReason reason, ...) {
+    struct GFXValidationResult location;
+    u32 reasonArgs[GFX_MAX_REASON_ARGS];
+    va_list args;
+    int i;
+
+    va_start(args, reason);
+    gfxReadReasonArgs(reason, reasonArgs, args);
+    va_end(args);
+
+    if (state->diagnostics) {
+        struct GFXDiagnostic* diagnostic = gfxLogDiagnostic(state, warning, GFXSeverityWarning);
 
-enum GFXValidatorError gfxValidateMoveWord(struct GFXValidatorState* state, Gfx* at) {
-    int index = MOVE_WORD_IDX(at);
-    int offset = MOVE_WORD_OFS(at);
-    int data = MOVE_WORD_DATA(at);
+        if (diagnostic) {
+            diagnostic->location.reasonId = reason;
 
-    switch (index) {
-        case G_MW_SEGMENT:
-            if (offset > GFX_MAX_SEGMENTS * 4 || offset < 0) {
-                sprintf(state->result->reasonMessage, "segment should be in the range [0, 15] got %d", offset >> 2);
-                return GFXValidatorInvalidArguments;
-            } else if (!gfxIsValidSegmentAddress(data)) {
-                sprintf(state->result->reasonMessage, "invalid ram address for segment %08x", data);
-                return GFXValidatorInvalidArguments;
+            for (i = 0; i < GFX_MAX_REASON_ARGS; ++i) {
+                diagnostic->location.reasonArgs[i] = reasonArgs[i];
             }
+        }
+    }
 
-            state->segments[offset>>2] = data;
-            break;
-        case G_MW_CLIP:
-            break;
-        case G_MW_MATRIX:
-            break;
-#ifdef F3DEX_GBI_2
-        case G_MW_FORCEMTX:
-            break;
-#else
-        case G_MW_POINTS:
-            break;
-#endif // F3DEX_GBI_2
-        case G_MW_NUMLIGHT:
-            break;
-        case G_MW_LIGHTCOL:
-            break;
-        case G_MW_FOG:
-            break;
-        case G_MW_PERSPNORM:
-            break;
-        default:
-            return GFXValidatorInvalidArguments;
+    if (state->onWarning) {
+        gfxSnapshotStack(state, &location);
+        location.reason = warning;
+        location.reasonId = reason;
+
+        for (i = 0; i < GFX_MAX_REASON_ARGS; ++i) {
+            location.reasonArgs[i] = reasonArgs[i];
+        }
+
+        state->onWarning(state->warningData, &location);
     }
-    
-    return GFXValidatorErrorNone;
 }
 
-enum GFXValidatorError gfxValidateTODO(struct GFXValidatorState* state, Gfx* at) {
-    return GFXValidatorErrorNone;
+enum GFXValidatorError gfxFail(struct GFXValidatorState* state, enum GFXValidatorError result) {
+    gfxSnapshotStack(state, state->result);
+    gfxCopyReason(state, state->result);
+    state->result->reason = result;
+    return result;
 }
 
-enum GFXValidatorError gfxValidateList(struct GFXValidatorState* state, Gfx* gfx, Gfx* segmentGfx) {
-    enum GFXValidatorError result = gfxPush(state, segmentGfx);
+// in collect all mode logs the error and returns 1 if validation can
+// continue past the current command
+int gfxRecover(struct GFXValidatorState* state, enum GFXValidatorError error) {
+    int i;
 
-    if (result != GFXValidatorErrorNone) {
-        return result;
+    if (!state->diagnostics || error == GFXValidatorCommandLimit) {
+        return 0;
+    }
+
+    struct GFXDiagnostic* diagnostic = gfxLogDiagnostic(state, error, GFXSeverityError);
+
+    if (diagnostic) {
+        gfxCopyReason(state, &diagnostic->location);
+    }
+
+    if (state->recoveredError == GFXValidatorErrorNone) {
+        state->recoveredError = error;
+        gfxSnapshotStack(state, state->result);
+        gfxCopyReason(state, state->result);
     }
 
-    int active = 1;
-    int stackLocation = state->result->gfxStackSize-1;
+    state->reasonId = GFXReasonNone;
 
-    while (active) {
-        int commandType = _SHIFTR(gfx->words.w0, 24, 8);
+    // the lists being walked have an error, the cache shouldn't skip them
+    for (i = 0; i < state->gfxStackSize; ++i) {
+        state->gfxStack[i].cacheable = 0;
+    }
+
+    return 1;
+}
+
+void gfxSkipCommand(struct GFXDisplayListFrame* frame) {
+    ++frame->gfx;
+    frame->address += sizeof(Gfx);
+}
+
+// validates commands until every display list has returned or the root
+// display list reaches streamEnd, the position is kept in the state so
+// calling again picks up where it left off
+enum GFXValidatorError gfxRun(struct GFXValidatorState* state) {
+    enum GFXValidatorError result;
+
+    if (state->result->reason != GFXValidatorErrorNone) {
+        return state->result->reason;
+    }
+
+    while (state->gfxStackSize) {
+        struct GFXDisplayListFrame* frame = &state->gfxStack[state->gfxStackSize - 1];
+
+        if (state->gfxStackSize == 1 && frame->address == state->streamEnd) {
+            return GFXValidatorErrorNone;
+        }
+
+        // every command is resolved on its own, a list missing its G_ENDDL
+        // can run off the end of the memory backing it
+        Gfx* gfx = gfxResolveList(state, frame->address);
+
+        if (!gfx) {
+            return gfxFail(state, GFXValidatorInvalidAddress);
+        }
+
+        frame->gfx = gfx;
+
+        int commandType = GFX_COMMAND(gfx);
+        const struct GFXCommandDescription* description = &state->microcode->commands[commandType];
+        GFXCommandValidator validate = state->validators[commandType];
+
+        if (state->sliceCommandsRemaining <= 0) {
+            return GFXValidatorIncomplete;
+        }
+
+        --state->sliceCommandsRemaining;
+
+        if (state->sliceCycles && 
+            (state->sliceCommandsRemaining & (GFX_CYCLE_CHECK_INTERVAL - 1)) == 0 && 
+            gfxCycleCount() - state->sliceStart >= state->sliceCycles) {
+            return GFXValidatorIncomplete;
+        }
 
-        if (commandType < 0 || commandType >= GFX_MAX_COMMAND_LEN) {
-            result = GFXValidatorInvalidCommand;
-            goto error;
+        if (state->commandsRemaining <= 0) {
+            gfxSetReason(state, GFXReasonCommandLimit);
+            return gfxFail(state, GFXValidatorCommandLimit);
         }
 
-        CommandValidator validator = gfxCommandValidators[commandType];
+        --state->commandsRemaining;
+        GFX_STAT_ADD(state, commands, 1);
+        GFX_STAT_ADD(state, commandCounts[commandType], 1);
 
-        if (!validator) {
-            sprintf(state->result->reasonMessage, "unrecongized command with id %08x", commandType);
-            result = GFXValidatorInvalidCommand;
-            goto error;
+        if (state->visitor) {
+            state->visitor(state->visitorData, state, gfx);
         }
 
-        result = validator(state, gfx);
+        gfxRecordRead(state, frame->address, sizeof(Gfx));
+
+        if (!validate) {
+            gfxSetReason(state, GFXReasonUnknownCommand, commandType);
+
+            if (!gfxRecover(state, GFXValidatorInvalidCommand)) {
+                return gfxFail(state, GFXValidatorInvalidCommand);
+            }
+
+            gfxSkipCommand(frame);
+            continue;
+        }
+
+        result = validate(state, gfx);
 
         if (result != GFXValidatorErrorNone) {
-            goto error;
+            if (!gfxRecover(state, result)) {
+                return gfxFail(state, result);
+            }
+
+            // a display list that failed validation isn't followed
+            if (description->kind == GFXCommandDL || description->kind == GFXCommandBranchZ) {
+                gfxSkipCommand(frame);
+                continue;
+            }
         }
 
-        switch (commandType) {
-            case (u8)G_ENDDL:
-                active = 0;
+        switch (description->kind) {
+            case GFXCommandEndDL:
+                gfxPop(state);
                 break;
-            case (u8)G_DL:
+            case GFXCommandDL:
                 {
                     int next;
-                    result = gfxTranslateAddress(state, gfx->dma.addr, &next);
+                    result = gfxTranslateAddress(state, DMA_ADDR(gfx), &next);
+
+                    if (result == GFXValidatorErrorNone) {
+                        if (DMA1_PARAM(gfx) == G_DL_NOPUSH) {
+                            result = gfxBranch(state, next);
+                        } else {
+                            if (state->sampler && !state->sampleDepth) {
+                                gfxBeginSample(state, next);
+                            }
+
+                            result = gfxCallList(state, next);
+                            // a list skipped by the cache or that couldn't
+                            // be pushed has already returned
+                            gfxEndSample(state);
+                        }
+                    }
 
                     if (result != GFXValidatorErrorNone) {
-                        goto error;
-                    }
+                        if (!gfxRecover(state, result)) {
+                            return gfxFail(state, result);
+                        }
 
-                    next = PHYS_TO_K0(next);
+                        // nothing sensible follows a branch that can't be
+                        // taken so it ends the list instead
+                        if (DMA1_PARAM(gfx) == G_DL_NOPUSH) {
+                            gfxPop(state);
+                        } else {
+                            gfxSkipCommand(frame);
+                        }
+                    }
+                }
+                break;
+            case GFXCommandBranchZ:
+                {
+                    int next;
+                    result = gfxTranslateAddress(state, state->pipeline.rdpHalf1, &next);
 
-                    if (gfx->dma.par == G_DL_NOPUSH) {
-                        gfx = (Gfx*)next;
-                    } else {
-                        result = gfxValidateList(state, (Gfx*)next, (Gfx*)gfx->dma.addr);
+                    if (result == GFXValidatorErrorNone) {
+                        result = gfxBranchZ(state, next);
+                    }
 
-                        if (result != GFXValidatorErrorNone) {
-                            goto error;
+                    if (result != GFXValidatorErrorNone) {
+                        if (!gfxRecover(state, result)) {
+                            return gfxFail(state, result);
                         }
 
-                        ++gfx;
+                        gfxSkipCommand(frame);
                     }
                 }
                 break;
             default:
-                ++gfx;
+                gfxSkipCommand(frame);
                 break;
         };
     }
 
-    gfxPop(state);
+    if (state->recoveredError != GFXValidatorErrorNone) {
+        state->result->reason = state->recoveredError;
+        return state->recoveredError;
+    }
+
     return GFXValidatorErrorNone;
-error:
-    state->result->gfxStack[stackLocation] = gfx;
-    return result;
 }
 
-enum GFXValidatorError gfxValidate(OSTask* task, int maxGfxCount, struct GFXValidationResult* validateResult) {
+enum GFXValidatorError gfxValidateList(struct GFXValidatorState* state, u32 address) {
+    enum GFXValidatorError result = gfxPush(state, address);
+
+    if (result != GFXValidatorErrorNone) {
+        return gfxFail(state, result);
+    }
+
+    return gfxRun(state);
+}
+
+enum GFXValidatorError gfxValidateDisplayList(u32 address, int maxGfxCount, struct GFXValidatorOptions* options, struct GFXValidationResult* validateResult) {
     struct GFXValidatorState state;
-    gfxInitState(&state, validateResult);
-    
-    if (task->t.type == M_GFXTASK) {
-        enum GFXValidatorError result = gfxValidateList(&state, (Gfx*)task->t.data_ptr, (Gfx*)task->t.data_ptr);
-        
-        if (result != GFXValidatorErrorNone) {
-            validateResult->reason = result;
-            return result;
-        }
+    gfxInitState(&state, validateResult, options, maxGfxCount);
+    return gfxValidateList(&state, address);
+}
+
+enum GFXValidatorError gfxValidateBegin(struct GFXValidatorState* cursor, u32 address, int maxGfxCount, struct GFXValidatorOptions* options, struct GFXValidationResult* result) {
+    gfxInitState(cursor, result, options, maxGfxCount);
+
+    enum GFXValidatorError error = gfxPush(cursor, address);
+
+    if (error != GFXValidatorErrorNone) {
+        return gfxFail(cursor, error);
     }
 
     return GFXValidatorErrorNone;
 }
 
-CommandValidator gfxCommandValidators[GFX_MAX_COMMAND_LEN] = {
-    [G_SPNOOP] = gfxValidateNoop,
-    [G_MTX] = gfxValidateMtx,
-    [G_MOVEMEM] = gfxValidateMoveMem,
-    [G_VTX] = gfxValidateVertex,
-    [G_DL] = gfxValidateDL,
-#ifdef G_SPRITE2D_BASE
-    [G_SPRITE2D_BASE] = gfxValidateSprite2DBase,
-#endif
+enum GFXValidatorError gfxValidateContinue(struct GFXValidatorState* cursor, int commandBudget, u32 cycleBudget) {
+    cursor->sliceCommandsRemaining = commandBudget > 0 ? commandBudget : GFX_UNLIMITED_SLICE;
+    cursor->sliceCycles = cycleBudget;
+    cursor->sliceStart = gfxCycleCount();
 
-    [(u8)G_TRI1] = gfxValidateTri1,
-#ifdef G_TRI2
-    [(u8)G_TRI2] = gfxValidateTri2,
-#endif
-    [(u8)G_CULLDL] = gfxValidateCullDL,
-    [(u8)G_POPMTX] = gfxValidatePopMtx,
-    [(u8)G_MOVEWORD] = gfxValidateMoveWord,
-
-    [(u8)G_MODIFYVTX] = gfxValidateTODO,
-    [(u8)G_BRANCH_Z] = gfxValidateTODO,
-    [(u8)G_QUAD] = gfxValidateTODO,
-    [(u8)G_SPECIAL_1] = gfxValidateTODO,
-    [(u8)G_SPECIAL_2] = gfxValidateTODO,
-    [(u8)G_SPECIAL_3] = gfxValidateTODO,
-    [(u8)G_DMA_IO] = gfxValidateTODO,
-    [(u8)G_TEXTURE] = gfxValidateTODO,
-    [(u8)G_SETOTHERMODE_H] = gfxValidateTODO,
-    [(u8)G_SETOTHERMODE_L] = gfxValidateTODO,
-    [(u8)G_ENDDL] = gfxValidateTODO,
-    [(u8)G_GEOMETRYMODE] = gfxValidateTODO,
-#ifdef F3DEX_GBI_2
-    [(u8)G_GEOMETRYMODE] = gfxValidateTODO,
-#else
-    [(u8)G_SETGEOMETRYMODE] = gfxValidateTODO,
-    [(u8)G_CLEARGEOMETRYMODE] = gfxValidateTODO,
-#endif
-    [(u8)G_LINE3D] = gfxValidateTODO,
-    [(u8)G_RDPHALF_1] = gfxValidateTODO,
-    [(u8)G_RDPHALF_2] = gfxValidateTODO,
-#ifdef F3DEX_GBI_2
-    [(u8)G_TRI2] = gfxValidateTODO,
-    [(u8)G_BRANCH_Z] = gfxValidateTODO,
-    [(u8)G_LOAD_UCODE] = gfxValidateTODO,
-#else
-    [(u8)G_RDPHALF_CONT] = gfxValidateTODO,
-#endif
-    [(u8)G_LOAD_UCODE] = gfxValidateMoveWord,
-
-    [(u8)G_NOOP] = gfxValidateTODO,
-
-    [(u8)G_SETCIMG] = gfxValidateTODO,
-    [(u8)G_SETZIMG] = gfxValidateTODO,
-    [(u8)G_SETTIMG] = gfxValidateTODO,
-    [(u8)G_SETCOMBINE] = gfxValidateTODO,
-    [(u8)G_SETENVCOLOR] = gfxValidateTODO,
-    [(u8)G_SETPRIMCOLOR] = gfxValidateTODO,
-    [(u8)G_SETBLENDCOLOR] = gfxValidateTODO,
-    [(u8)G_SETFOGCOLOR] = gfxValidateTODO,
-    [(u8)G_SETFILLCOLOR] = gfxValidateTODO,
-    [(u8)G_FILLRECT] = gfxValidateTODO,
-    [(u8)G_SETTILE] = gfxValidateTODO,
-    [(u8)G_LOADTILE] = gfxValidateTODO,
-    [(u8)G_LOADBLOCK] = gfxValidateTODO,
-    [(u8)G_SETTILESIZE] = gfxValidateTODO,
-    [(u8)G_LOADTLUT] = gfxValidateTODO,
-    [(u8)G_RDPSETOTHERMODE] = gfxValidateTODO,
-    [(u8)G_SETPRIMDEPTH] = gfxValidateTODO,
-    [(u8)G_SETSCISSOR] = gfxValidateTODO,
-    [(u8)G_SETCONVERT] = gfxValidateTODO,
-    [(u8)G_SETKEYR] = gfxValidateTODO,
-    [(u8)G_SETKEYGB] = gfxValidateTODO,
-    [(u8)G_RDPFULLSYNC] = gfxValidateTODO,
-    [(u8)G_RDPTILESYNC] = gfxValidateTODO,
-    [(u8)G_RDPPIPESYNC] = gfxValidateTODO,
-    [(u8)G_RDPLOADSYNC] = gfxValidateTODO,
-    [(u8)G_TEXRECTFLIP] = gfxValidateTODO,
-    [(u8)G_TEXRECT] = gfxValidateTODO,
-};
\ No newline at end of file
+    enum GFXValidatorError result = gfxRun(cursor);
+
+    cursor->sliceCommandsRemaining = GFX_UNLIMITED_SLICE;
+    cursor->sliceCycles = 0;
+
+    return result;
+}
+
+enum GFXValidatorError gfxStreamBegin(struct GFXValidatorState* state, u32 address, int maxGfxCount, struct GFXValidatorOptions* options, struct GFXValidationResult* result) {
+    gfxInitState(state, result, options, maxGfxCount);
+    state->streamEnd = address;
+
+    enum GFXValidatorError error = gfxPush(state, address);
+
+    if (error != GFXValidatorErrorNone) {
+        return gfxFail(state, error);
+    }
+
+    return GFXValidatorErrorNone;
+}
+
+enum GFXValidatorError gfxStreamValidateTo(struct GFXValidatorState* state, u32 endAddress) {
+    state->streamEnd = endAddress;
+    return gfxRun(state);
+}
+
+enum GFXValidatorError gfxStreamEnd(struct GFXValidatorState* state) {
+    if (state->result->reason != GFXValidatorErrorNone) {
+        return state->result->reason;
+    }
+
+    if (state->gfxStackSize) {
+        gfxSetReason(state, GFXReasonStreamUnterminated);
+        return gfxFail(state, GFXValidatorInvalidCommand);
+    }
+
+    return GFXValidatorErrorNone;
+}
+
+enum GFXValidatorError gfxValidateTaskAt(u32 taskAddress, int maxGfxCount, struct GFXValidatorOptions* options, struct GFXValidationResult* validateResult) {
+    u32* task = gfxMemoryResolve(options->memory, taskAddress, GFX_TASK_SIZE);
+
+    if (!task) {
+        struct GFXValidatorState state;
+        gfxInitState(&state, validateResult, options, maxGfxCount);
+        gfxSetReason(&state, GFXReasonTaskNotInRAM, (unsigned)taskAddress);
+        return gfxFail(&state, GFXValidatorInvalidAddress);
+    }
+
+    if (GFX_WORD(task[GFX_TASK_TYPE_OFFSET / 4]) != M_GFXTASK) {
+        struct GFXValidatorState state;
+        gfxInitState(&state, validateResult, options, maxGfxCount);
+        return GFXValidatorErrorNone;
+    }
+
+    return gfxValidateDisplayList(K0_TO_PHYS(GFX_WORD(task[GFX_TASK_DATA_PTR_OFFSET / 4])), maxGfxCount, options, validateResult);
+}
+
+#ifndef GFX_HOST
+enum GFXValidatorError gfxValidate(OSTask* task, int maxGfxCount, struct GFXValidationResult* validateResult) {
+    struct GFXValidatorOptions options = {0};
+
+    if (task->t.type != M_GFXTASK) {
+        struct GFXValidatorState state;
+        gfxInitState(&state, validateResult, &options, maxGfxCount);
+        return GFXValidatorErrorNone;
+    }
+    
+    return gfxValidateDisplayList(K0_TO_PHYS(task->t.data_ptr), maxGfxCount, &options, validateResult);
+}
+
+enum GFXValidatorError gfxValidateTaskBegin(struct GFXValidatorState* cursor, OSTask* task, int maxGfxCount, struct GFXValidationResult* result) {
+    struct GFXValidatorOptions options = {0};
+
+    if (task->t.type != M_GFXTASK) {
+        // nothing to validate, the first gfxValidateContinue finishes
+        gfxInitState(cursor, result, &options, maxGfxCount);
+        return GFXValidatorErrorNone;
+    }
+
+    return gfxValidateBegin(cursor, K0_TO_PHYS(task->t.data_ptr), maxGfxCount, &options, result);
+}
+#endif
\ No newline at end of file
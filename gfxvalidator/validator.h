@@ -3,6 +3,17 @@
 #define _GFX_VALIDATOR_VALIDATOR_H
 
 #include <ultra64.h>
+#include "memory.h"
+#include "reasons.h"
+
+struct GFXValidationCache;
+struct GFXDiagnosticLog;
+struct GFXFrameStats;
+struct GFXValidatorState;
+struct GFXMicrocode;
+struct GFXRegionIndex;
+struct GFXHazardMap;
+struct GFXSampler;
 
 #define GFX_MAX_COMMAND_LEN     256
 
@@ -10,11 +21,43 @@
 #define GFX_MAX_GFX_STACK       10
 #define GFX_MAX_MATRIX_STACK    10
 
+// open addressed set of the branch targets taken by the display lists on the
+// stack, must be a power of 2 and larger than GFX_MAX_BRANCH_TARGETS
+#define GFX_BRANCH_SET_SIZE     64
+#define GFX_MAX_BRANCH_TARGETS  32
+
+// entry in GFXValidatorOptions.segments for a segment that isn't set
+#define GFX_SEGMENT_UNSET       0xFFFFFFFF
+
+// streamEnd when the whole display list is available up front
+#define GFX_NO_STREAM_END       0xFFFFFFFF
+
 #define GFX_INITIALIZED_PMTX    (1 << 0)
 #define GFX_INITIALIZED_MMTX    (1 << 1)
+#define GFX_INITIALIZED_TIMG    (1 << 2)
+#define GFX_INITIALIZED_NUMLIGHT    (1 << 3)
+#define GFX_INITIALIZED_CIMG    (1 << 4)
+#define GFX_INITIALIZED_ZIMG    (1 << 5)
+#define GFX_INITIALIZED_SCISSOR (1 << 6)
+// the color image, depth image, scissor or othermode changed since the
+// render target was last checked
+#define GFX_RENDER_TARGET_DIRTY (1 << 7)
+#define GFX_INITIALIZED_RDPHALF1    (1 << 8)
+
+#define GFX_MAX_TILES           8
+// TMEM is 4KB, tracked in 64 bit words
+#define GFX_TMEM_WORDS          512
 
 #define GFX_MAX_REASON_LENGTH   96
 
+// building with GFX_DISABLE_STANDARD_VALIDATION leaves out both levels above
+// GFXValidationCheap
+#ifdef GFX_DISABLE_STANDARD_VALIDATION
+#ifndef GFX_DISABLE_EXHAUSTIVE_VALIDATION
+#define GFX_DISABLE_EXHAUSTIVE_VALIDATION
+#endif
+#endif
+
 enum GFXValidatorError {
     GFXValidatorErrorNone,
     GFXValidatorStackOverflow,
@@ -25,26 +68,270 @@ enum GFXValidatorError {
     GFXValidatorInvalidAddress,
     GFXValidatorInvalidArguments,
     GFXValidatorUnitialized,
+    GFXValidatorCommandLimit,
+    GFXValidatorInfiniteLoop,
+    GFXValidatorMissingSync,
     GFXValidatorErrorCount,
+    // not an error, returned by gfxValidateContinue when the budget ran out
+    // before the display list was finished
+    GFXValidatorIncomplete,
+    // warnings, passed to GFXValidatorOptions.onWarning and validation
+    // continues
+    GFXValidatorRedundantSync,
+    // reported by gfxFindRedundantState
+    GFXValidatorRedundantState,
+    // reported by gfxCheckGeometry
+    GFXValidatorBadGeometry,
+};
+
+// how much of each command is checked, see GFXValidatorOptions.level. each
+// level has its own table of validators so the checks it skips cost nothing
+enum GFXValidationLevel {
+    // everything, including what is loaded in TMEM and the vertex buffer and
+    // GFXValidatorOptions.regions
+    GFXValidationExhaustive,
+    // also the pipeline state commands depend on, syncs, lighting, tiles,
+    // texture loads and the render target
+    GFXValidationStandard,
+    // only what can be checked from the command itself and its addresses,
+    // the display list stack, matrix stack and segment table
+    GFXValidationCheap,
+    GFXValidationLevelCount,
 };
 
 struct GFXValidationResult {
-    Gfx* gfxStack[GFX_MAX_GFX_STACK];
+    // copy of the command each display list on the stack was at so the
+    // result can still be printed once the memory is gone
+    Gfx gfxStack[GFX_MAX_GFX_STACK];
+    // physical address of each entry in gfxStack
+    u32 gfxStackAddress[GFX_MAX_GFX_STACK];
     char gfxStackSize;
+    // enum GFXMicrocodeId the commands in gfxStack are encoded for
+    u8 microcode;
     enum GFXValidatorError reason;
-    char reasonMessage[GFX_MAX_REASON_LENGTH];
+    // enum GFXReason, format it with gfxFormatReason
+    u16 reasonId;
+    u32 reasonArgs[GFX_MAX_REASON_ARGS];
 };
 
-struct GFXValidatorState {
-    struct GFXValidationResult* result;
+// location holds the display list stack at the command that caused the
+// warning, it is only valid during the call
+typedef void (*GFXWarningCallback)(void* data, struct GFXValidationResult* location);
+
+// called with each command just before it is validated, the display list
+// stack and pipeline state in state are as they were before the command
+typedef void (*GFXCommandVisitor)(void* data, struct GFXValidatorState* state, Gfx* command);
+
+typedef enum GFXValidatorError (*GFXCommandValidator)(struct GFXValidatorState* state, Gfx* at);
+
+struct GFXValidatorOptions {
+    // where display lists and the data they reference are read from
+    // defaults to RDRAM when running on the console
+    struct GFXMemory* memory;
+    // optional, skips display lists that were already validated with the
+    // same starting state
+    struct GFXValidationCache* cache;
+    // optional, called for each performance warning
+    GFXWarningCallback onWarning;
+    void* warningData;
+    // optional, validation keeps going after errors that leave the display
+    // list walkable and logs every error and warning here. the result and
+    // return value then report the first error once validation finishes
+    struct GFXDiagnosticLog* diagnostics;
+    // optional, see gfxDisassemble
+    GFXCommandVisitor visitor;
+    void* visitorData;
+    // optional, counters are added to while validating, see stats.h
+    struct GFXFrameStats* stats;
+    // optional, GFX_MAX_SEGMENTS physical addresses the segment table starts
+    // with for display lists that expect segments to be set by their caller
+    const u32* segments;
+    // optional, the microcode the display list was built for, defaults to
+    // gfxDefaultMicrocode()
+    const struct GFXMicrocode* microcode;
+    // optional, every range of memory the RSP and RDP read from or write to
+    // has to be inside one of these regions, see regions.h
+    const struct GFXRegionIndex* regions;
+    // optional, every range of memory the task reads is marked here, see
+    // hazards.h. options.cache is ignored so nothing is skipped
+    struct GFXHazardMap* hazards;
+    // optional, defaults to GFXValidationExhaustive. regions are only
+    // checked at that level and hazards need at least GFXValidationStandard
+    // to see texture loads. building with GFX_DISABLE_EXHAUSTIVE_VALIDATION
+    // or GFX_DISABLE_STANDARD_VALIDATION removes those levels, selecting one
+    // of them validates at the most thorough level that is left
+    enum GFXValidationLevel level;
+    // optional, checks only some frames and display lists at level and walks
+    // the rest at GFXValidationCheap, see sampler.h
+    struct GFXSampler* sampler;
+};
+
+struct GFXDisplayListFrame {
+    Gfx* gfx;
+    u32 address;
+    // where the display list being walked starts, a branch starts a new one
+    u32 startAddress;
+    // branch set entries added while this frame was on top of the stack
+    char branchLogStart;
+    char cacheable;
+    // used to record the frame in the validation cache when it returns
+    u32 listAddress;
+    u32 cacheKey;
+    int commandsRemainingAtEntry;
+};
+
+struct GFXImage {
+    u32 address;
+    u16 width;
+    u8 format;
+    u8 size;
+};
+
+// 10.2 fixed point
+struct GFXRect {
+    u16 ulx;
+    u16 uly;
+    u16 lrx;
+    u16 lry;
+};
+
+struct GFXTile {
+    u8 format;
+    u8 size;
+    u8 palette;
+    // in 64 bit words
+    u16 line;
+    u16 tmem;
+    // 10.2 fixed point
+    u16 uls;
+    u16 ult;
+    u16 lrs;
+    u16 lrt;
+};
+
+// everything a display list can read or modify while it runs, the
+// validation cache hashes and copies this as a whole
+struct GFXPipelineState {
     int segments[GFX_MAX_SEGMENTS];
     short matrixStackSize;
     int flags;
+    // bit per vertex buffer slot loaded by G_VTX since the task started
+    u32 loadedVertices;
+    u32 geometryMode;
+    // directional lights set by G_MW_NUMLIGHT, not counting the ambient light
+    u8 numLights;
+    // bit per lookat and light slot loaded with G_MOVEMEM
+    u16 loadedLights;
+    u32 othermodeH;
+    u32 othermodeL;
+    // addresses are physical
+    struct GFXImage textureImage;
+    struct GFXImage colorImage;
+    struct GFXImage depthImage;
+    struct GFXRect scissor;
+    struct GFXTile tiles[GFX_MAX_TILES];
+    // bit per tile that has been through G_SETTILE
+    u8 initializedTiles;
+    // set by G_TEXTURE
+    u8 textureTile;
+    u8 textureLevels;
+    u8 textureOn;
+    // GFX_SYNC_* flags, see sync.c
+    u8 syncState;
+    // tiles read by primitives since the last G_RDPTILESYNC
+    u8 tileSyncPending;
+    // bit per TMEM word holding texture data or palette entries
+    u32 tmemLoaded[GFX_TMEM_WORDS / 32];
+    u32 tmemPalette[GFX_TMEM_WORDS / 32];
+    // w1 of the last G_RDPHALF_1, the display list G_BRANCH_Z branches to
+    u32 rdpHalf1;
+};
+
+struct GFXBranchSet {
+    u32 addresses[GFX_BRANCH_SET_SIZE];
+    // slots in the order they were filled so they can be removed again when a
+    // display list returns
+    unsigned char log[GFX_MAX_BRANCH_TARGETS];
+    char logSize;
+};
+
+struct GFXValidatorState {
+    struct GFXValidationResult* result;
+    struct GFXMemory* memory;
+    const struct GFXMicrocode* microcode;
+    // microcode->validators for level
+    const GFXCommandValidator* validators;
+    enum GFXValidationLevel level;
+    // set on frames the sampler doesn't check in full, display lists it
+    // picks are validated at sampleLevel and everything else at baseLevel
+    struct GFXSampler* sampler;
+    enum GFXValidationLevel sampleLevel;
+    enum GFXValidationLevel baseLevel;
+    // gfxStackSize of the display list being sampled, 0 if there isn't one
+    char sampleDepth;
+    const struct GFXRegionIndex* regions;
+    struct GFXHazardMap* hazards;
+    struct GFXDisplayListFrame gfxStack[GFX_MAX_GFX_STACK];
+    char gfxStackSize;
+    struct GFXBranchSet branches;
+    int commandsRemaining;
+    struct GFXValidationCache* cache;
+    GFXWarningCallback onWarning;
+    void* warningData;
+    struct GFXDiagnosticLog* diagnostics;
+    GFXCommandVisitor visitor;
+    void* visitorData;
+#ifndef GFX_DISABLE_STATS
+    struct GFXFrameStats* stats;
+#endif
+    // first error logged to diagnostics
+    enum GFXValidatorError recoveredError;
+    // validators describe errors here with gfxSetReason, it is copied into
+    // the result or diagnostic the error is reported to
+    u16 reasonId;
+    u32 reasonArgs[GFX_MAX_REASON_ARGS];
+    // validation pauses when the root display list reaches this address
+    u32 streamEnd;
+    // validation pauses when either runs out, see gfxValidateContinue
+    int sliceCommandsRemaining;
+    u32 sliceStart;
+    u32 sliceCycles;
+#ifndef GFX_HOST
+    struct GFXMemory defaultMemory;
+#endif
+    struct GFXPipelineState pipeline;
 };
 
 typedef void (*gfxPrinter)(char* output, unsigned outputLength);
 
+#ifndef GFX_HOST
 enum GFXValidatorError gfxValidate(OSTask* task, int maxGfxCount, struct GFXValidationResult* result);
+enum GFXValidatorError gfxValidateTaskBegin(struct GFXValidatorState* cursor, OSTask* task, int maxGfxCount, struct GFXValidationResult* result);
+#endif
+enum GFXValidatorError gfxValidateDisplayList(u32 address, int maxGfxCount, struct GFXValidatorOptions* options, struct GFXValidationResult* result);
+// validates the OSTask stored at the physical address taskAddress
+enum GFXValidatorError gfxValidateTaskAt(u32 taskAddress, int maxGfxCount, struct GFXValidatorOptions* options, struct GFXValidationResult* result);
+// validates a display list a slice at a time, cursor keeps the position,
+// segment table and matrix state between calls. gfxValidateContinue runs
+// until commandBudget commands were checked or cycleBudget cycles
+// (osGetCount ticks, nanoseconds on the host) have passed, 0 means no
+// limit. it returns GFXValidatorIncomplete until the display list is done.
+// the display list must not change until validation is finished
+enum GFXValidatorError gfxValidateBegin(struct GFXValidatorState* cursor, u32 address, int maxGfxCount, struct GFXValidatorOptions* options, struct GFXValidationResult* result);
+enum GFXValidatorError gfxValidateContinue(struct GFXValidatorState* cursor, int commandBudget, u32 cycleBudget);
+
+// validates a display list while it is being built, address is where the
+// root display list starts. call gfxStreamValidateTo after emitting commands
+// with the address just past the last one written and gfxStreamEnd once the
+// list is complete. an error stops the stream and is returned by every
+// call after it
+enum GFXValidatorError gfxStreamBegin(struct GFXValidatorState* state, u32 address, int maxGfxCount, struct GFXValidatorOptions* options, struct GFXValidationResult* result);
+enum GFXValidatorError gfxStreamValidateTo(struct GFXValidatorState* state, u32 endAddress);
+enum GFXValidatorError gfxStreamEnd(struct GFXValidatorState* state);
+
 void gfxGenerateReadableMessage(struct GFXValidationResult* result, gfxPrinter printer);
+// writes the reason text for result, output must hold GFX_MAX_REASON_LENGTH
+// bytes. returns the length written
+unsigned gfxFormatReason(struct GFXValidationResult* result, char* output);
 
 #endif
\ No newline at end of file
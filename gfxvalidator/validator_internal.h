@@ -0,0 +1,138 @@
+#ifndef _GFX_VALIDATOR_VALIDATOR_INTERNAL_H
+#define _GFX_VALIDATOR_VALIDATOR_INTERNAL_H
+
+#include "validator.h"
+#include "microcode.h"
+#include "regions.h"
+#include "hazards.h"
+
+#ifndef GFX_DISABLE_STATS
+#include "stats.h"
+#endif
+
+#ifdef GFX_HOST
+#include <stdio.h>
+#endif
+
+// adds to a GFXFrameStats counter when stats are being collected
+#ifdef GFX_DISABLE_STATS
+#define GFX_STAT_ADD(state, counter, amount)
+#define GFX_STAT_MAX(state, counter, value)
+#else
+#define GFX_STAT_ADD(state, counter, amount) do { \
+        if ((state)->stats) (state)->stats->counter += (amount); \
+    } while (0)
+#define GFX_STAT_MAX(state, counter, value) do { \
+        if ((state)->stats && (state)->stats->counter < (u32)(value)) (state)->stats->counter = (value); \
+    } while (0)
+#endif
+
+int gfxIsAligned(int addr, int to);
+// records why the current command failed, takes the numeric arguments the
+// format for reason expects
+void gfxSetReason(struct GFXValidatorState* state, enum GFXReason reason, ...);
+// reports a warning at the current command, takes the same arguments as
+// gfxSetReason
+void gfxWarn(struct GFXValidatorState* state, enum GFXValidatorError warning, enum GFXReason reason, ...);
+enum GFXValidatorError gfxTranslateAddress(struct GFXValidatorState* state, int address, int* output);
+// checks the physical range [physical, physical + length) is inside a
+// registered region when GFXValidatorOptions.regions is set, address is
+// the segmented address it came from
+enum GFXValidatorError gfxCheckRegion(struct GFXValidatorState* state, int address, u32 physical, u32 length);
+// checks [address, address + length) is in RAM and inside a registered
+// region when GFXValidatorOptions.regions is set
+enum GFXValidatorError gfxValidateAddress(struct GFXValidatorState* state, int address, u32 length, int alignedTo);
+// gfxValidateAddress for memory the RSP or RDP reads, also marks it in
+// GFXValidatorOptions.hazards
+enum GFXValidatorError gfxValidateRead(struct GFXValidatorState* state, int address, u32 length, int alignedTo);
+void gfxRecordRead(struct GFXValidatorState* state, u32 physical, u32 length);
+int gfxIsValidSegmentAddress(struct GFXValidatorState* state, int addr);
+
+// validators shared by every microcode, the rest are in microcode_commands.h
+enum GFXValidatorError gfxValidateNoop(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateRDPNoop(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateRDPHalf1(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateSetPrimDepth(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateDL(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateSprite2DBase(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxCheckLighting(struct GFXValidatorState* state);
+enum GFXValidatorError gfxSetOtherModeBits(struct GFXValidatorState* state, u32* mode, int sft, int len, u32 data);
+enum GFXValidatorError gfxSetOtherMode(struct GFXValidatorState* state, u32* mode, int sft, int len, u32 data);
+enum GFXValidatorError gfxValidateRDPSetOtherModeCheap(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateRDPSetOtherMode(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateTODO(struct GFXValidatorState* state, Gfx* at);
+
+// framebuffer.c
+enum GFXValidatorError gfxCheckRenderTarget(struct GFXValidatorState* state);
+enum GFXValidatorError gfxValidateSetColorImageCheap(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateSetColorImage(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateSetDepthImageCheap(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateSetDepthImage(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateSetScissor(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateRectCheap(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateFillRect(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateTextureRect(struct GFXValidatorState* state, Gfx* at);
+
+// sync.c
+void gfxRecordPrimitive(struct GFXValidatorState* state, int tiles);
+void gfxRecordLoad(struct GFXValidatorState* state);
+int gfxPrimitiveTiles(struct GFXValidatorState* state);
+enum GFXValidatorError gfxCheckPipeSync(struct GFXValidatorState* state);
+enum GFXValidatorError gfxCheckTileSync(struct GFXValidatorState* state, int tile);
+enum GFXValidatorError gfxCheckLoadSync(struct GFXValidatorState* state);
+enum GFXValidatorError gfxValidateRDPAttribute(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidatePipeSync(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateTileSync(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateLoadSync(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateFullSync(struct GFXValidatorState* state, Gfx* at);
+
+// texture.c
+enum GFXValidatorError gfxValidateSetTextureImage(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateSetTileCheap(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateSetTile(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateSetTileSizeCheap(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateSetTileSizeStandard(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateSetTileSize(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateLoadBlockCheap(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateLoadBlockStandard(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateLoadBlock(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateLoadTileCheap(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateLoadTLUTCheap(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateLoadTileStandard(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateLoadTile(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateLoadTLUTStandard(struct GFXValidatorState* state, Gfx* at);
+enum GFXValidatorError gfxValidateLoadTLUT(struct GFXValidatorState* state, Gfx* at);
+
+// command_printer.c, printers shared by every microcode
+int gfxNoopCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxDLCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxEndDLCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxRDPHalf1CommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxRDPHalf2CommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxLoadUcodeCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxDmaIOCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxSpecialCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxRDPNoopCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxSetColorImageCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxSetDepthImageCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxSetTextureImageCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxSetCombineCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxSetColorCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxSetPrimColorCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxSetFillColorCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxFillRectCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxSetTileCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxSetTileSizeCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxLoadTileCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxLoadBlockCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxLoadTLUTCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxRDPSetOtherModeCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxSetPrimDepthCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxSetScissorCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxSetConvertCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxSetKeyRCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxSetKeyGBCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxSyncCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+int gfxTextureRectCommandPrinter(Gfx command, char* output, unsigned maxOutputLength);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,217 @@
+// writes and replays captures of a single graphics task
+//
+//   gfxcapture [-n max_commands] [-u microcode] rdram_image task_address capture
+//   gfxcapture [-n max_commands] -r [-g] capture...
+//
+// the first form captures the OSTask at task_address in an RDRAM image so
+// it can be passed around without the whole image, -u names the microcode
+// it was built for. -r validates captures written here or on the console
+// with gfxCaptureTask using the microcode stored in them. -g also transforms
+// every vertex in the capture and reports geometry that can't be drawn
+// correctly
+
+#include "../gfxvalidator/capture.h"
+#include "../gfxvalidator/host/capture_replay.h"
+#include "../gfxvalidator/host/geometry.h"
+#include "../gfxvalidator/host/rdram_snapshot.h"
+#include "../gfxvalidator/error_printer.h"
+#include "../gfxvalidator/microcode.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define DEFAULT_MAX_COMMANDS    1000000
+#define CAPTURE_BLOBS           4096
+
+FILE* captureFile;
+int captureWriteFailed;
+
+void printToStdout(char* output, unsigned outputLength) {
+    fwrite(output, 1, outputLength, stdout);
+
+    if (outputLength && output[outputLength - 1] != '\n') {
+        fputc('\n', stdout);
+    }
+}
+
+void writeCapture(char* output, unsigned outputLength) {
+    if (fwrite(output, 1, outputLength, captureFile) != outputLength) {
+        captureWriteFailed = 1;
+    }
+}
+
+void usage(const char* program) {
+    fprintf(stderr, "usage: %s [-n max_commands] [-u microcode] rdram_image task_address capture\n", program);
+    fprintf(stderr, "       %s [-n max_commands] -r [-g] capture...\n", program);
+    exit(2);
+}
+
+int capture(const char* imagePath, u32 taskAddress, const char* capturePath, struct GFXValidatorOptions* options, int maxGfxCount) {
+    struct GFXRDRAMSnapshot snapshot;
+
+    if (gfxSnapshotOpen(&snapshot, imagePath) != 0) {
+        perror(imagePath);
+        return 2;
+    }
+
+    captureFile = fopen(capturePath, "wb");
+
+    if (!captureFile) {
+        perror(capturePath);
+        return 2;
+    }
+
+    u32* lines = calloc(GFX_HAZARD_LINE_WORDS(snapshot.memory.size), sizeof(u32));
+    struct GFXCaptureBlob* blobs = calloc(CAPTURE_BLOBS, sizeof(struct GFXCaptureBlob));
+    struct GFXHazardMap reads;
+    struct GFXCaptureWriter writer;
+    struct GFXValidationResult result;
+
+    if (!lines || !blobs) {
+        fprintf(stderr, "out of memory\n");
+        return 2;
+    }
+
+    gfxHazardMapInit(&reads, lines, snapshot.memory.size);
+    gfxCaptureWriterInit(&writer, writeCapture, &reads, blobs, CAPTURE_BLOBS);
+    options->memory = &snapshot.memory;
+
+    enum GFXValidatorError error = gfxCaptureTaskAt(taskAddress, maxGfxCount, options, &writer, &result);
+
+    if (fclose(captureFile) != 0 || captureWriteFailed) {
+        perror(capturePath);
+        return 2;
+    }
+
+    if (!writer.bytes) {
+        fprintf(stderr, "0x%08x isn't a graphics task\n", (unsigned)taskAddress);
+        remove(capturePath);
+        return 1;
+    }
+
+    printf(
+        "%s: %u bytes, %u of %u chunks repeated\n",
+        capturePath,
+        (unsigned)writer.bytes,
+        (unsigned)writer.repeatedChunks,
+        (unsigned)writer.chunks
+    );
+
+    if (error != GFXValidatorErrorNone) {
+        gfxGenerateReadableMessage(&result, printToStdout);
+    }
+
+    free(lines);
+    free(blobs);
+    gfxSnapshotClose(&snapshot);
+
+    return 0;
+}
+
+void printWarning(void* data, struct GFXValidationResult* location) {
+    gfxGenerateReadableMessage(location, printToStdout);
+}
+
+int replay(const char* capturePath, struct GFXValidatorOptions* options, int maxGfxCount, int checkGeometry) {
+    struct GFXCapture capture;
+    struct GFXValidationResult result;
+    enum GFXValidatorError error;
+
+    if (gfxCaptureOpen(&capture, capturePath) != 0) {
+        perror(capturePath);
+        return 1;
+    }
+
+    if (checkGeometry) {
+        struct GFXValidatorOptions geometryOptions = *options;
+        struct GFXGeometryReport* report = malloc(sizeof(struct GFXGeometryReport));
+
+        if (!report) {
+            fprintf(stderr, "out of memory\n");
+            exit(2);
+        }
+
+        geometryOptions.memory = &capture.memory;
+        geometryOptions.segments = capture.segments;
+        geometryOptions.microcode = capture.microcode;
+        geometryOptions.onWarning = printWarning;
+
+        gfxGeometryReportInit(report);
+        error = gfxCheckGeometry(capture.listAddress, maxGfxCount, &geometryOptions, report, &result);
+        gfxPrintGeometryReport(report, printToStdout);
+        free(report);
+    } else {
+        error = gfxReplayCapture(&capture, maxGfxCount, options, &result);
+    }
+
+    if (error != GFXValidatorErrorNone) {
+        printf("%s: failed\n", capturePath);
+        gfxGenerateReadableMessage(&result, printToStdout);
+        gfxCaptureClose(&capture);
+        return 1;
+    }
+
+    printf("%s: ok\n", capturePath);
+    gfxCaptureClose(&capture);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    int maxGfxCount = DEFAULT_MAX_COMMANDS;
+    int replayCaptures = 0;
+    int checkGeometry = 0;
+    int option;
+    struct GFXValidatorOptions options = {0};
+
+    options.microcode = gfxDefaultMicrocode();
+
+    while ((option = getopt(argc, argv, "n:u:rg")) != -1) {
+        switch (option) {
+            case 'n':
+                maxGfxCount = atoi(optarg);
+                break;
+            case 'u':
+                options.microcode = gfxFindMicrocode(optarg);
+
+                if (!options.microcode) {
+                    fprintf(stderr, "unknown microcode %s\n", optarg);
+                    return 2;
+                }
+                break;
+            case 'r':
+                replayCaptures = 1;
+                break;
+            case 'g':
+                checkGeometry = 1;
+                break;
+            default:
+                usage(argv[0]);
+        }
+    }
+
+    if (checkGeometry && !replayCaptures) {
+        usage(argv[0]);
+    }
+
+    if (replayCaptures) {
+        int failed = 0;
+
+        if (optind == argc) {
+            usage(argv[0]);
+        }
+
+        for (int i = optind; i < argc; ++i) {
+            failed |= replay(argv[i], &options, maxGfxCount, checkGeometry);
+        }
+
+        return failed;
+    }
+
+    if (argc - optind != 3) {
+        usage(argv[0]);
+    }
+
+    return capture(argv[optind], K0_TO_PHYS((u32)strtoul(argv[optind + 1], 0, 16)), argv[optind + 2], &options, maxGfxCount);
+}
\ No newline at end of file
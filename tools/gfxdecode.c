@@ -0,0 +1,101 @@
+// prints validation results sent from the console with gfxEncodeResult
+//
+//   gfxdecode [file]
+//
+// the file holds any number of encoded results back to back, stdin is read
+// when no file is given. bytes that don't start a result are skipped. each
+// result is printed with the microcode it was encoded with
+
+#include "../gfxvalidator/host/result_decoder.h"
+#include "../gfxvalidator/error_printer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define READ_CHUNK_SIZE     65536
+
+void printToStdout(char* output, unsigned outputLength) {
+    fwrite(output, 1, outputLength, stdout);
+
+    if (outputLength && output[outputLength - 1] != '\n') {
+        fputc('\n', stdout);
+    }
+}
+
+unsigned char* readAll(FILE* input, unsigned* lengthOut) {
+    unsigned char* data = 0;
+    unsigned length = 0;
+    unsigned capacity = 0;
+    size_t bytesRead;
+
+    do {
+        if (capacity - length < READ_CHUNK_SIZE) {
+            capacity += READ_CHUNK_SIZE;
+            data = realloc(data, capacity);
+
+            if (!data) {
+                fprintf(stderr, "out of memory\n");
+                exit(2);
+            }
+        }
+
+        bytesRead = fread(data + length, 1, capacity - length, input);
+        length += bytesRead;
+    } while (bytesRead);
+
+    *lengthOut = length;
+    return data;
+}
+
+int main(int argc, char* argv[]) {
+    FILE* input = stdin;
+
+    if (argc > 2) {
+        fprintf(stderr, "usage: gfxdecode [file]\n");
+        return 2;
+    }
+
+    if (argc == 2) {
+        input = fopen(argv[1], "rb");
+
+        if (!input) {
+            perror(argv[1]);
+            return 2;
+        }
+    }
+
+    unsigned length;
+    unsigned char* data = readAll(input, &length);
+    unsigned offset = 0;
+    int resultCount = 0;
+
+    while (offset < length) {
+        struct GFXValidationResult result;
+        int used = gfxDecodeResult(data + offset, length - offset, &result);
+
+        if (used < 0) {
+            ++offset;
+            continue;
+        }
+
+        if (used == 0) {
+            fprintf(stderr, "truncated result at offset %u\n", offset);
+            break;
+        }
+
+        if (resultCount++) {
+            fputc('\n', stdout);
+        }
+
+        gfxGenerateReadableMessage(&result, printToStdout);
+        offset += used;
+    }
+
+    free(data);
+
+    if (input != stdin) {
+        fclose(input);
+    }
+
+    return 0;
+}
@@ -0,0 +1,166 @@
+// rewrites a display list in a binary image with redundant commands
+// removed, triangles merged and trivial calls flattened
+//
+//   gfxoptimize [-n max_commands] [-u microcode] [-s segment=address]... image list_address [output]
+//
+// the image is loaded at physical address 0, -s sets a segment the display
+// list expects to already be set and -u names the microcode it was built
+// for, f3d or f3dex2. the optimized list replaces the original
+// in place and the space it no longer needs is zeroed, which reads as
+// G_SPNOOP. the image is written to output when one is given
+
+#include "../gfxvalidator/host/optimizer.h"
+#include "../gfxvalidator/error_printer.h"
+#include "../gfxvalidator/microcode.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define DEFAULT_MAX_COMMANDS    1000000
+
+void printToStdout(char* output, unsigned outputLength) {
+    fwrite(output, 1, outputLength, stdout);
+
+    if (outputLength && output[outputLength - 1] != '\n') {
+        fputc('\n', stdout);
+    }
+}
+
+unsigned char* readImage(const char* path, u32* lengthOut) {
+    FILE* file = fopen(path, "rb");
+
+    if (!file) {
+        perror(path);
+        exit(2);
+    }
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    unsigned char* data = malloc(length > 0 ? length : 1);
+
+    if (!data) {
+        fprintf(stderr, "out of memory\n");
+        exit(2);
+    }
+
+    if (fread(data, 1, length, file) != (size_t)length) {
+        perror(path);
+        exit(2);
+    }
+
+    fclose(file);
+    *lengthOut = (u32)length;
+    return data;
+}
+
+void usage(const char* program) {
+    fprintf(stderr, "usage: %s [-n max_commands] [-u microcode] [-s segment=address]... image list_address [output]\n", program);
+    exit(2);
+}
+
+int main(int argc, char* argv[]) {
+    int maxGfxCount = DEFAULT_MAX_COMMANDS;
+    const struct GFXMicrocode* microcode = gfxDefaultMicrocode();
+    u32 segments[GFX_MAX_SEGMENTS];
+    unsigned segment;
+    unsigned long segmentAddress;
+    int option;
+
+    for (int i = 0; i < GFX_MAX_SEGMENTS; ++i) {
+        segments[i] = GFX_SEGMENT_UNSET;
+    }
+
+    while ((option = getopt(argc, argv, "n:s:u:")) != -1) {
+        switch (option) {
+            case 'n':
+                maxGfxCount = atoi(optarg);
+                break;
+            case 's':
+                if (sscanf(optarg, "%u=%lx", &segment, &segmentAddress) != 2 || segment >= GFX_MAX_SEGMENTS) {
+                    usage(argv[0]);
+                }
+                segments[segment] = (u32)segmentAddress;
+                break;
+            case 'u':
+                microcode = gfxFindMicrocode(optarg);
+
+                if (!microcode) {
+                    fprintf(stderr, "unknown microcode %s\n", optarg);
+                    return 2;
+                }
+                break;
+            default:
+                usage(argv[0]);
+        }
+    }
+
+    if (argc - optind != 2 && argc - optind != 3) {
+        usage(argv[0]);
+    }
+
+    u32 imageLength;
+    unsigned char* image = readImage(argv[optind], &imageLength);
+    u32 address = (u32)strtoul(argv[optind + 1], 0, 16);
+
+    struct GFXMemory memory;
+    gfxLinearMemoryInit(&memory, image, imageLength);
+
+    struct GFXValidatorOptions options = {0};
+    options.memory = &memory;
+    options.segments = segments;
+    options.microcode = microcode;
+
+    // the optimized list is never longer than the original
+    struct GFXOptimizedList output;
+    output.capacity = (imageLength - (address < imageLength ? address : imageLength)) / sizeof(Gfx);
+    output.commands = malloc(output.capacity * sizeof(Gfx) + 1);
+
+    if (!output.commands) {
+        fprintf(stderr, "out of memory\n");
+        return 2;
+    }
+
+    struct GFXOptimizeStats stats;
+    struct GFXValidationResult result;
+
+    if (gfxOptimizeDisplayList(address, address, maxGfxCount, &options, &output, &stats, &result) != GFXValidatorErrorNone) {
+        printf("0x%08x: failed\n", (unsigned)address);
+        gfxGenerateReadableMessage(&result, printToStdout);
+        return 1;
+    }
+
+    printf(
+        "0x%08x: %u -> %u commands, saved %u bytes\n",
+        (unsigned)address,
+        (unsigned)stats.inputCommands,
+        (unsigned)stats.outputCommands,
+        (unsigned)((stats.inputCommands - stats.outputCommands) * sizeof(Gfx))
+    );
+    printf(
+        "  noops %u, redundant %u, triangles merged %u, lists flattened %u\n",
+        (unsigned)stats.noopsRemoved,
+        (unsigned)stats.redundantRemoved,
+        (unsigned)stats.trianglesMerged,
+        (unsigned)stats.listsFlattened
+    );
+
+    if (argc - optind == 3) {
+        memcpy(image + address, output.commands, stats.outputCommands * sizeof(Gfx));
+        memset(image + address + stats.outputCommands * sizeof(Gfx), 0, (stats.inputCommands - stats.outputCommands) * sizeof(Gfx));
+
+        FILE* file = fopen(argv[optind + 2], "wb");
+
+        if (!file || fwrite(image, 1, imageLength, file) != imageLength) {
+            perror(argv[optind + 2]);
+            return 2;
+        }
+
+        fclose(file);
+    }
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+// validates captured graphics tasks on the host
+//
+//   gfxvalidate [-j threads] [-n max_commands] [-u microcode] manifest
+//
+// each line of the manifest names an RDRAM image and the address of the
+// OSTask to validate in it, optionally followed by the microcode the task
+// was built for. lines without one use -u
+//
+//   captures/frame_0001.bin 0x80123450
+//   captures/title_0001.bin 0x80201230 f3d
+//
+// results are printed in manifest order
+
+#include "../gfxvalidator/host/batch.h"
+#include "../gfxvalidator/error_printer.h"
+#include "../gfxvalidator/microcode.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define DEFAULT_MAX_COMMANDS    1000000
+#define MAX_LINE_LENGTH         4096
+
+void printToStdout(char* output, unsigned outputLength) {
+    fwrite(output, 1, outputLength, stdout);
+
+    if (outputLength && output[outputLength - 1] != '\n') {
+        fputc('\n', stdout);
+    }
+}
+
+int readManifest(FILE* manifest, int maxGfxCount, const struct GFXMicrocode* defaultMicrocode, struct GFXBatchJob** jobsOut) {
+    char line[MAX_LINE_LENGTH];
+    char path[MAX_LINE_LENGTH];
+    char microcodeName[MAX_LINE_LENGTH];
+    unsigned long taskAddress;
+    struct GFXBatchJob* jobs = 0;
+    int jobCount = 0;
+    int jobCapacity = 0;
+    int lineNumber = 0;
+
+    while (fgets(line, sizeof(line), manifest)) {
+        ++lineNumber;
+
+        if (line[0] == '#' || line[strspn(line, " \t\r\n")] == '\0') {
+            continue;
+        }
+
+        int fields = sscanf(line, "%4095s %lx %4095s", path, &taskAddress, microcodeName);
+
+        if (fields < 2) {
+            fprintf(stderr, "manifest line %d: expected '<rdram image> <task address> [microcode]'\n", lineNumber);
+            continue;
+        }
+
+        const struct GFXMicrocode* microcode = fields == 3 ? gfxFindMicrocode(microcodeName) : defaultMicrocode;
+
+        if (!microcode) {
+            fprintf(stderr, "manifest line %d: unknown microcode %s\n", lineNumber, microcodeName);
+            continue;
+        }
+
+        if (jobCount == jobCapacity) {
+            jobCapacity = jobCapacity ? jobCapacity * 2 : 64;
+            jobs = realloc(jobs, sizeof(struct GFXBatchJob) * jobCapacity);
+
+            if (!jobs) {
+                fprintf(stderr, "out of memory\n");
+                exit(2);
+            }
+        }
+
+        struct GFXBatchJob* job = &jobs[jobCount++];
+        memset(job, 0, sizeof(struct GFXBatchJob));
+        job->snapshotPath = strdup(path);
+        job->taskAddress = K0_TO_PHYS(taskAddress);
+        job->maxGfxCount = maxGfxCount;
+        job->microcode = microcode;
+    }
+
+    *jobsOut = jobs;
+    return jobCount;
+}
+
+int main(int argc, char* argv[]) {
+    int threadCount = 0;
+    int maxGfxCount = DEFAULT_MAX_COMMANDS;
+    const struct GFXMicrocode* microcode = gfxDefaultMicrocode();
+    int option;
+
+    while ((option = getopt(argc, argv, "j:n:u:")) != -1) {
+        switch (option) {
+            case 'j':
+                threadCount = atoi(optarg);
+                break;
+            case 'n':
+                maxGfxCount = atoi(optarg);
+                break;
+            case 'u':
+                microcode = gfxFindMicrocode(optarg);
+
+                if (!microcode) {
+                    fprintf(stderr, "unknown microcode %s\n", optarg);
+                    return 2;
+                }
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-j threads] [-n max_commands] [-u microcode] manifest\n", argv[0]);
+                return 2;
+        }
+    }
+
+    if (optind + 1 != argc) {
+        fprintf(stderr, "usage: %s [-j threads] [-n max_commands] [-u microcode] manifest\n", argv[0]);
+        return 2;
+    }
+
+    FILE* manifest = strcmp(argv[optind], "-") ? fopen(argv[optind], "r") : stdin;
+
+    if (!manifest) {
+        perror(argv[optind]);
+        return 2;
+    }
+
+    struct GFXBatchJob* jobs;
+    int jobCount = readManifest(manifest, maxGfxCount, microcode, &jobs);
+
+    if (manifest != stdin) {
+        fclose(manifest);
+    }
+
+    int failed = gfxValidateBatch(jobs, jobCount, threadCount);
+
+    for (int i = 0; i < jobCount; ++i) {
+        struct GFXBatchJob* job = &jobs[i];
+
+        if (job->openError) {
+            printf("%s 0x%08x: %s\n", job->snapshotPath, (unsigned)job->taskAddress, strerror(job->openError));
+        } else if (job->error != GFXValidatorErrorNone) {
+            printf("%s 0x%08x: failed\n", job->snapshotPath, (unsigned)job->taskAddress);
+            gfxGenerateReadableMessage(&job->result, printToStdout);
+        } else {
+            printf("%s 0x%08x: ok\n", job->snapshotPath, (unsigned)job->taskAddress);
+        }
+    }
+
+    printf("%d of %d tasks failed\n", failed, jobCount);
+
+    return failed ? 1 : 0;
+}